@@ -8,8 +8,8 @@ ROOT="$(cd "$(dirname "$0")" && pwd)"
 mkdir -p "$ROOT/web_build"
 
 # --- gather all source files -------------------------------------------
-# Finds .cpp and .c under src/ and builds a space-separated list
-SRC_FILES=$(find "$ROOT/src" -type f \( -name '*.cpp' -o -name '*.c' \))
+# Finds .cpp and .c under src/ and builds a space-separated list (minus the headless sim)
+SRC_FILES=$(find "$ROOT/src" -type f \( -name '*.cpp' -o -name '*.c' \) -not -path "$ROOT/src/sim/*")
 
 # --- compile & link with em++ ------------------------------------------
 em++ $SRC_FILES \
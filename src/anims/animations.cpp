@@ -1,9 +1,14 @@
 #include "animations.hpp"
+#include "texture_cache.hpp"
+#include "atlas.hpp"
 
 Animation Animation_Load(const char* filepath, int frameCount, float frameTime, bool looping)
 {
     Animation anim = {};
-    anim.texture = LoadTexture(filepath);
+    if (!Atlas_Find(filepath, &anim.texture, &anim.region)) {
+        anim.textureRef = TextureCache_Acquire(filepath, &anim.texture);
+        anim.region = (Rectangle){ 0.0f, 0.0f, (float)anim.texture.width, (float)anim.texture.height };
+    }
     anim.frameCount = frameCount;
     anim.currentFrame = 0;
     anim.frameTime = frameTime;
@@ -11,8 +16,8 @@ Animation Animation_Load(const char* filepath, int frameCount, float frameTime,
     anim.looping = looping;
     anim.flipped = false;
 
-    anim.frameWidth  = (float)anim.texture.width / frameCount;
-    anim.frameHeight = (float)anim.texture.height;
+    anim.frameWidth  = anim.region.width / frameCount;
+    anim.frameHeight = anim.region.height;
     return anim;
 }
 
@@ -44,16 +49,16 @@ void Animation_Draw(const Animation* anim, Vector2 position, float scale, Color
     const float fh = anim->frameHeight;
 
     Rectangle src;
-    src.y = 0.0f;
+    src.y = anim->region.y;
     src.height = fh;
 
     if (anim->flipped) {
         // Start at the right-> edge of the frame and read <-left
-        src.x = (anim->currentFrame + 1) * fw;
+        src.x = anim->region.x + (anim->currentFrame + 1) * fw;
         src.width = -fw;
     } else {
         // Normal: left to right
-        src.x = anim->currentFrame * fw;
+        src.x = anim->region.x + anim->currentFrame * fw;
         src.width = fw;
     }
 
@@ -70,7 +75,10 @@ void Animation_Draw(const Animation* anim, Vector2 position, float scale, Color
 
 void Animation_Unload(Animation* anim)
 {
-    if (anim && anim->texture.id != 0)
-        UnloadTexture(anim->texture);
+    if (!anim) return;
+    TextureCache_Release(anim->textureRef);
+    anim->textureRef = -1;
+    anim->texture = Texture2D{};
+    anim->region = Rectangle{};
 }
 
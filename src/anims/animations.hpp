@@ -1,8 +1,14 @@
 #pragma once
 #include "raylib.h"
+#include <cstdint>
 
+// Per-instance frame state over a shared sprite sheet. Copies share the same texture
+// reference; use Animation_Load/Unload to take and drop references. The sheet is either a
+// rect in the sprite atlas or a whole texture from the texture cache.
 struct Animation {
-    Texture2D texture;
+    Texture2D texture;        // atlas or texture cache, never owned
+    Rectangle region;         // the sheet's frames within texture
+    int32_t textureRef = -1;  // cache handle (-1 when in the atlas), released by Animation_Unload
     int frameCount;
     int currentFrame;
     float frameWidth;
@@ -14,7 +20,7 @@ struct Animation {
 };
 
 
-// Load an animation from a spritesheet file
+// Load an animation from a spritesheet file (atlas if packed there, else the texture cache)
 Animation Animation_Load(const char* filepath, int frameCount, float frameTime, bool looping = true);
 
 // Update animation frame timer
@@ -23,7 +29,7 @@ void Animation_Update(Animation* anim, float dt);
 // Draw animation centered at position
 void Animation_Draw(const Animation* anim, Vector2 position, float scale = 1.0f, Color tint = WHITE);
 
-// Unload the animation’s texture
+// Drop the animation’s texture reference
 void Animation_Unload(Animation* anim);
 
 // Reset animation to first frame
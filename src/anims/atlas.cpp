@@ -0,0 +1,145 @@
+#include "atlas.hpp"
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct AtlasEntry {
+    std::string path;
+    Rectangle   rect;
+};
+
+static Texture2D               g_atlasTex = {};
+static std::vector<AtlasEntry> g_atlasEntries;
+static AtlasStats              g_atlasStats = {};
+
+static const int kPadding   = 2;   // keeps linear filtering from bleeding between sheets
+static const int kWhiteSize = 4;   // white block for shapes; its centre texel is used
+static const int kMaxSize   = 4096;
+
+struct PackItem {
+    int   w, h;
+    int   x, y;
+    int   image;   // index into the loaded images, -1 for the white block
+};
+
+// Shelf packing into a width x (returned) height area, tallest items first
+static int PackShelves(std::vector<PackItem>& items, int width) {
+    int x = 0, y = 0, shelfH = 0;
+    for (PackItem& it : items) {
+        const int w = it.w + kPadding, h = it.h + kPadding;
+        if (w > width) return -1;
+        if (x + w > width) { y += shelfH; x = 0; shelfH = 0; }
+        it.x = x;
+        it.y = y;
+        x += w;
+        shelfH = std::max(shelfH, h);
+    }
+    return y + shelfH;
+}
+
+static int NextPow2(int v) {
+    int p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+bool Atlas_Build(const char* const* paths, int32_t count) {
+    Atlas_Unload();
+
+    std::vector<Image>       images;
+    std::vector<std::string> names;
+    for (int32_t i = 0; i < count; ++i) {
+        if (std::find(names.begin(), names.end(), paths[i]) != names.end()) continue;
+        Image img = LoadImage(paths[i]);
+        if (!img.data) continue;
+        ImageFormat(&img, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        images.push_back(img);
+        names.push_back(paths[i]);
+    }
+    if (images.empty()) return false;
+
+    std::vector<PackItem> items;
+    for (size_t i = 0; i < images.size(); ++i)
+        items.push_back({ images[i].width, images[i].height, 0, 0, (int)i });
+    items.push_back({ kWhiteSize, kWhiteSize, 0, 0, -1 });
+    std::sort(items.begin(), items.end(), [](const PackItem& a, const PackItem& b) {
+        return a.h != b.h ? a.h > b.h : a.w > b.w;
+    });
+
+    // Smallest power-of-two square-ish area that fits
+    int width = 256, height = -1;
+    for (; width <= kMaxSize; width *= 2) {
+        height = PackShelves(items, width);
+        if (height > 0 && height <= width) break;
+    }
+    if (width > kMaxSize || height <= 0) {
+        for (Image& img : images) UnloadImage(img);
+        TraceLog(LOG_WARNING, "ATLAS: sprite sheets don't fit in %dx%d", kMaxSize, kMaxSize);
+        return false;
+    }
+    height = NextPow2(height);
+
+    Image atlas = GenImageColor(width, height, BLANK);
+    uint8_t* dst = (uint8_t*)atlas.data;
+    Rectangle white = {};
+
+    for (const PackItem& it : items) {
+        if (it.image < 0) {
+            for (int y = 0; y < it.h; ++y)
+                memset(dst + ((size_t)(it.y + y) * width + it.x) * 4, 0xFF, (size_t)it.w * 4);
+            white = (Rectangle){ (float)it.x + 1.0f, (float)it.y + 1.0f, 1.0f, 1.0f };
+            continue;
+        }
+        const Image& img = images[it.image];
+        const uint8_t* src = (const uint8_t*)img.data;
+        for (int y = 0; y < it.h; ++y)
+            memcpy(dst + ((size_t)(it.y + y) * width + it.x) * 4,
+                   src + (size_t)y * it.w * 4, (size_t)it.w * 4);
+        g_atlasEntries.push_back({ names[it.image],
+                                   (Rectangle){ (float)it.x, (float)it.y, (float)it.w, (float)it.h } });
+    }
+
+    g_atlasTex = LoadTextureFromImage(atlas);
+    UnloadImage(atlas);
+    for (Image& img : images) UnloadImage(img);
+
+    if (g_atlasTex.id == 0) {
+        g_atlasEntries.clear();
+        return false;
+    }
+
+    SetShapesTexture(g_atlasTex, white);
+
+    g_atlasStats.sheets = (int32_t)g_atlasEntries.size();
+    g_atlasStats.width  = width;
+    g_atlasStats.height = height;
+    TraceLog(LOG_INFO, "ATLAS: packed %d sheets into %dx%d", g_atlasStats.sheets, width, height);
+    return true;
+}
+
+void Atlas_Unload() {
+    if (g_atlasTex.id != 0) {
+        // Back to raylib's default white pixel
+        SetShapesTexture((Texture2D){}, (Rectangle){});
+        UnloadTexture(g_atlasTex);
+    }
+    g_atlasTex = Texture2D{};
+    g_atlasEntries.clear();
+    g_atlasStats = AtlasStats{};
+}
+
+bool Atlas_Find(const char* path, Texture2D* outTex, Rectangle* outRect) {
+    if (!path || g_atlasTex.id == 0) return false;
+    for (const AtlasEntry& e : g_atlasEntries) {
+        if (e.path != path) continue;
+        if (outTex)  *outTex  = g_atlasTex;
+        if (outRect) *outRect = e.rect;
+        return true;
+    }
+    return false;
+}
+
+const AtlasStats& Atlas_Stats() {
+    return g_atlasStats;
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include "raylib.h"
+#include <cstdint>
+
+// Load-time sprite atlas. Packs the given sprite sheets into one texture and also reserves
+// a white texel that becomes raylib's shapes texture. Sprites, rectangles and circles then
+// all sample the same texture and raylib keeps them in one batch, instead of flushing on
+// every texture switch.
+
+struct AtlasStats {
+    int32_t sheets;     // sheets packed
+    int32_t width;
+    int32_t height;
+};
+
+// Packs the sheets that load. Returns false if nothing could be packed (e.g. no GPU
+// context, or no files), in which case sprites keep using their own textures.
+bool Atlas_Build(const char* const* paths, int32_t count);
+void Atlas_Unload();
+
+// Atlas texture and the sheet's rect in it; false if the sheet isn't in the atlas
+bool Atlas_Find(const char* path, Texture2D* outTex, Rectangle* outRect);
+
+const AtlasStats& Atlas_Stats();
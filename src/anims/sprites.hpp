@@ -0,0 +1,13 @@
+#pragma once
+
+// Sprite sheet paths, shared by the loaders and the atlas packer
+
+#define SPRITE_PLAYER_IDLE "../../assets/player/player_idle.png"
+#define SPRITE_PLAYER_RUN  "../../assets/player/player_run.png"
+#define SPRITE_ENEMY_RUN   "../../assets/enemies/enemy_run.png"
+
+static const char* const kSpriteSheets[] = {
+    SPRITE_PLAYER_IDLE,
+    SPRITE_PLAYER_RUN,
+    SPRITE_ENEMY_RUN,
+};
@@ -0,0 +1,78 @@
+#include "texture_cache.hpp"
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+struct CachedTexture {
+    std::string path;
+    Texture2D   tex;
+    int32_t     refs;
+};
+
+static std::vector<CachedTexture>               g_textures;
+static std::vector<int32_t>                     g_freeTextures;
+static std::unordered_map<std::string, int32_t> g_textureByPath;
+static TextureCacheStats                        g_textureStats;
+
+static Texture2D RaylibLoad(const char* path) { return LoadTexture(path); }
+static void RaylibUnload(Texture2D tex) { if (tex.id != 0) UnloadTexture(tex); }
+
+static TextureLoadFn   g_load   = RaylibLoad;
+static TextureUnloadFn g_unload = RaylibUnload;
+
+int32_t TextureCache_Acquire(const char* path, Texture2D* outTex) {
+    if (!path || !path[0]) return -1;
+
+    auto it = g_textureByPath.find(path);
+    if (it != g_textureByPath.end()) {
+        CachedTexture& t = g_textures[it->second];
+        t.refs++;
+        g_textureStats.hits++;
+        if (outTex) *outTex = t.tex;
+        return it->second;
+    }
+
+    int32_t h;
+    if (!g_freeTextures.empty()) {
+        h = g_freeTextures.back();
+        g_freeTextures.pop_back();
+    } else {
+        h = (int32_t)g_textures.size();
+        g_textures.push_back({});
+    }
+
+    CachedTexture& t = g_textures[h];
+    t.path = path;
+    t.tex  = g_load(path);
+    t.refs = 1;
+    g_textureByPath[t.path] = h;
+
+    g_textureStats.loads++;
+    g_textureStats.resident++;
+    if (outTex) *outTex = t.tex;
+    return h;
+}
+
+void TextureCache_Release(int32_t handle) {
+    if (handle < 0 || handle >= (int32_t)g_textures.size()) return;
+    CachedTexture& t = g_textures[handle];
+    if (t.refs <= 0 || --t.refs > 0) return;
+
+    g_unload(t.tex);
+    g_textureByPath.erase(t.path);
+    t.path.clear();
+    t.tex = Texture2D{};
+    g_freeTextures.push_back(handle);
+
+    g_textureStats.unloads++;
+    g_textureStats.resident--;
+}
+
+void TextureCache_SetLoader(TextureLoadFn load, TextureUnloadFn unload) {
+    g_load   = load   ? load   : RaylibLoad;
+    g_unload = unload ? unload : RaylibUnload;
+}
+
+const TextureCacheStats& TextureCache_Stats() {
+    return g_textureStats;
+}
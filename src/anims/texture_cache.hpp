@@ -0,0 +1,27 @@
+#pragma once
+#include "raylib.h"
+#include <cstdint>
+
+// Reference-counted textures keyed by file path. Acquiring a path that is already resident
+// bumps its count instead of touching disk or the GPU; the texture is unloaded when the
+// last reference is released.
+
+typedef Texture2D (*TextureLoadFn)(const char* path);
+typedef void      (*TextureUnloadFn)(Texture2D tex);
+
+struct TextureCacheStats {
+    uint64_t loads    = 0;   // loader calls (cache misses)
+    uint64_t hits     = 0;   // acquires served from a resident texture
+    uint64_t unloads  = 0;
+    uint32_t resident = 0;   // textures currently loaded
+};
+
+// Returns a handle (>= 0) and writes the texture, or -1 if the path is empty
+int32_t TextureCache_Acquire(const char* path, Texture2D* outTex);
+void    TextureCache_Release(int32_t handle);
+
+// Replace the raylib loader, e.g. with a stub for headless runs. nullptr restores raylib.
+// Only call while nothing is resident.
+void TextureCache_SetLoader(TextureLoadFn load, TextureUnloadFn unload);
+
+const TextureCacheStats& TextureCache_Stats();
@@ -5,24 +5,45 @@
 #include "../physics/physics.h"
 #include "../level/level.h"
 #include "../anims/animations.hpp"
+#include "../anims/sprites.hpp"
+#include "../pathfinding/pathfinding.h"
+#include "../pathfinding/repath.h"
+#include "../jobs/jobs.h"
 #include "../../lib/box2d/include/box2d/box2d.h"
 #include <cmath>
 #include <cstdlib>
-#include <queue>
 #include <vector>
 #include <unordered_map>
 #include <algorithm>
 
 std::vector<Enemy> g_enemies;
+std::vector<EnemyCold> g_enemyCold;
 std::unordered_map<int, size_t> g_enemyIndexByEntId;
 
 int g_enemiesKilled = 0;
 int g_wave = 0;
 float g_speedMultiplier = 1.0f;
+PathMode g_pathMode = PathMode::AStar;
+RepathScheduler g_repath;
 
 static b2WorldId g_lastWorld;
 static const Grid* g_lastGrid = nullptr;
 static Vector2 g_lastPlayerPos = {0};
+static FlowField g_flowField;
+
+static const float kRepathEvery = 0.35f;
+// Fixed so the searches serviced per tick don't depend on the thread count; Path_FindBatch
+// spreads each batch over however many workers there are
+static const uint32_t kRepathBatch = 16;
+
+static std::vector<PathRequest> g_repathRequests;
+static std::vector<size_t>      g_repathEnemies;
+
+struct RepathContext {
+    EntitySystem* es;
+    const Grid*   grid;
+    Vector2       playerPx;
+};
 
 struct EnemyAI {
     std::vector<Vector2> path;
@@ -32,21 +53,43 @@ struct EnemyAI {
 
 static std::unordered_map<int, EnemyAI> sEnemyAI;
 
-struct Node {
-    int x, y;
-    float g, h;
-    int parentX, parentY;
-};
-
 Enemy* Enemy_FromEntityId(int entId) {
     auto it = g_enemyIndexByEntId.find(entId);
     if (it == g_enemyIndexByEntId.end()) return nullptr;
     return &g_enemies[it->second];
 }
 
+bool Enemies_Damage(EntitySystem* es, int32_t e, float dmg, float slowSec, const char* tag) {
+    if (e < 0 || !(es->flags[e] & ENTITY_ACTIVE) || es->kind[e] != EntityKind::Enemy) return false;
+    Enemy* en = Enemy_FromEntityId(es->id[e]);
+    if (!en) return false;
+    en->health -= dmg;
+    if (slowSec > 0.0f) en->slowTimer = slowSec;
+    TraceLog(LOG_INFO, "%s Enemy %d (HP=%.1f)", tag, es->id[e], en->health);
+    return true;
+}
+
+void Enemies_RemoveAt(size_t index) {
+    if (index >= g_enemies.size()) return;
+    Animation_Unload(&g_enemyCold[index].runAnim);
+    g_enemyIndexByEntId.erase(g_enemies[index].entId);
+
+    size_t last = g_enemies.size() - 1;
+    if (index != last)
+    {
+        g_enemyIndexByEntId[g_enemies[last].entId] = index;
+        std::swap(g_enemies[index], g_enemies[last]);
+        std::swap(g_enemyCold[index], g_enemyCold[last]);
+    }
+    g_enemies.pop_back();
+    g_enemyCold.pop_back();
+}
+
 void Enemies_Clear() {
-    for (Enemy& e : g_enemies) Animation_Unload(&e.runAnim);
+    for (EnemyCold& c : g_enemyCold) Animation_Unload(&c.runAnim);
     g_enemies.clear();
+    g_enemyCold.clear();
+    Repath_Clear(&g_repath);
     g_enemyIndexByEntId.clear();
 }
 
@@ -57,8 +100,7 @@ static bool LineOfSightFloor(const Grid* g, Vector2 aPx, Vector2 bPx) {
     int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
     int err = dx + dy;
     while (true) {
-        Tile* t = grid_at((Grid*)g, x0, y0);
-        if (!t || t->id != TILE_FLOOR) return false;
+        if (!grid_walkable(g, x0, y0)) return false;
         if (x0 == x1 && y0 == y1) break;
         int e2 = 2 * err;
         if (e2 >= dy) { err += dy; x0 += sx; }
@@ -67,75 +109,39 @@ static bool LineOfSightFloor(const Grid* g, Vector2 aPx, Vector2 bPx) {
     return true;
 }
 
-static inline float Heuristic(int x1, int y1, int x2, int y2) {
-    return fabsf((float)(x1 - x2)) + fabsf((float)(y1 - y2)); // Manhattan
-}
-
-// A* PATHFIND 
-static bool AStar_FindPath(const Grid* g, Vector2 startPx, Vector2 goalPx, std::vector<Vector2>& outPath) {
-    outPath.clear();
-
-    const int W = g->w, H = g->h;
-    int sx = (int)(startPx.x / TILE_SIZE);
-    int sy = (int)(startPx.y / TILE_SIZE);
-    int gx = (int)(goalPx.x / TILE_SIZE);
-    int gy = (int)(goalPx.y / TILE_SIZE);
-
-    auto in_bounds = [&](int x, int y) { return x >= 0 && y >= 0 && x < W && y < H; };
-    auto passable  = [&](int x, int y) { Tile* t = grid_at((Grid*)g, x, y); return t && t->id == TILE_FLOOR; };
-
-    struct CellKey { int x, y; bool operator==(const CellKey& o) const { return x==o.x && y==o.y; } };
-    struct Hash { size_t operator()(const CellKey& c) const { return (size_t)c.x * 73856093 ^ (size_t)c.y * 19349663; } };
-
-    struct PQEntry { float f; CellKey key; };
-    struct PQCompare { bool operator()(const PQEntry& a, const PQEntry& b) const { return a.f > b.f; } };
-
-    std::priority_queue<PQEntry, std::vector<PQEntry>, PQCompare> open;
-    std::unordered_map<CellKey, Node, Hash> nodes;
-
-    CellKey start{sx, sy};
-    Node startNode{sx, sy, 0, Heuristic(sx, sy, gx, gy), -1, -1};
-    nodes[start] = startNode;
-    open.push({ startNode.g + startNode.h, start });
-    const int dirs[4][2] = { {1,0},{-1,0},{0,1},{0,-1} };
-
-    bool found = false;
-    while (!open.empty()) {
-        CellKey curKey = open.top().key;
-        open.pop();
-
-        Node& cur = nodes[curKey];
-        if (cur.x == gx && cur.y == gy) { found = true; break; }
-
-        for (auto& d : dirs) {
-            int nx = cur.x + d[0];
-            int ny = cur.y + d[1];
-            if (!in_bounds(nx, ny) || !passable(nx, ny)) continue;
-
-            CellKey nk{nx, ny};
-            float newG = cur.g + 1.0f;
-            auto it = nodes.find(nk);
-            if (it == nodes.end() || newG < it->second.g) {
-                Node next{nx, ny, newG, Heuristic(nx, ny, gx, gy), cur.x, cur.y};
-                nodes[nk] = next;
-                open.push({ newG + next.h, nk });
-            }
-        }
+// Runs a batch of queued searches across the job workers. Entity positions were synced at
+// the end of the last tick; g_enemies doesn't change while the batch runs, so each search
+// writes straight into its enemy's path.
+static uint32_t Enemy_RunRepathBatch(const int32_t* entIds, uint32_t count, void* user) {
+    RepathContext* ctx = (RepathContext*)user;
+    g_repathRequests.clear();
+    g_repathEnemies.clear();
+
+    for (uint32_t i = 0; i < count; ++i) {
+        auto it = g_enemyIndexByEntId.find(entIds[i]);
+        if (it == g_enemyIndexByEntId.end()) continue;
+        const size_t k = it->second;
+        g_enemies[k].repathQueued = false;
+
+        const int32_t e = Entities_Index(ctx->es, entIds[i]);
+        if (e < 0) continue;
+
+        g_repathRequests.push_back({ ctx->es->pos[e], ctx->playerPx, &g_enemyCold[k].path, false });
+        g_repathEnemies.push_back(k);
     }
 
-    if (!found) return false;
+    Path_FindBatch(&g_pathCache, g_pathMode, ctx->grid, g_repathRequests.data(),
+                   (int32_t)g_repathRequests.size(), g_jobs);
 
-    // Backtrack path
-    std::vector<Vector2> rev;
-    Node cur = nodes[{gx, gy}];
-    while (cur.parentX != -1) {
-        rev.push_back({ cur.x * (float)TILE_SIZE + TILE_SIZE * 0.5f,
-            cur.y * (float)TILE_SIZE + TILE_SIZE * 0.5f });
-        cur = nodes[{cur.parentX, cur.parentY}];
+    for (size_t k : g_repathEnemies) {
+        g_enemies[k].repathCd = kRepathEvery;
+        g_enemies[k].waypoint = 0;
     }
-    std::reverse(rev.begin(), rev.end());
-    outPath = rev;
-    return true;
+    return (uint32_t)g_repathEnemies.size();
+}
+
+void Enemies_OnTilesChanged() {
+    FlowField_Invalidate(&g_flowField);
 }
 
 // Init and spawn enemies.
@@ -145,45 +151,44 @@ void Enemies_Spawn(EntitySystem* es, const Grid* g, Vector2 playerPos, int count
     int W = g->w;
     int H = g->h;
 
+    // At most one reallocation for the whole wave (still growing geometrically)
+    const size_t want = g_enemies.size() + (size_t)count;
+    if (want > g_enemies.capacity()) {
+        const size_t cap = std::max(want, g_enemies.capacity() * 2);
+        g_enemies.reserve(cap);
+        g_enemyCold.reserve(cap);
+    }
+    g_enemyIndexByEntId.reserve(want);
+
     for (int i = 0; i < count; ++i) {
         int tries = 0;
         while (tries++ < 500) {
             int x = GetRandomValue(0, W - 1);
             int y = GetRandomValue(0, H - 1);
-            Tile* t = grid_at((Grid*)g, x, y);
-            if (!t || t->id != TILE_FLOOR) continue;
+            if (!grid_walkable(g, x, y)) continue;
 
             Vector2 pos = { x * TILE_SIZE + TILE_SIZE * 0.5f, y * TILE_SIZE + TILE_SIZE * 0.5f };
             if (Vector2Distance(pos, playerPos) < minDist) continue;
 
             // Create base entity
-            Entity e;
-            e.id = es->nextId++;
-            e.kind = EntityKind::Enemy;
-            e.pos = pos;
-            e.half = { 10.0f, 10.0f };
-            e.color = GREEN;
-            e.active = true;
-            e.element = ElementType::NONE;
-            e.telekinetic = false;
-            es->pool.push_back(e);
-
-            // Reference to that entity (stable since std::vector won’t reallocate until capacity is exceeded)
-            Entity* entPtr = &es->pool.back();
+            int entId = Entities_CreateBox(es, EntityKind::Enemy, pos, { 10.0f, 10.0f }, GREEN);
+            if (!entId) return;
 
             // Create Enemy data
             Enemy en;
-            en.entId = e.id;
+            en.entId = entId;
             en.health = 100.f;
             en.maxHealth = 100.f;
             en.slowTimer = 0.f;
-
-            en.runAnim = Animation_Load("../../assets/enemies/enemy_run.png", 4, 0.25f);
             en.animState = EnemyAnimState::Run;
             en.facingRight = true;
 
-            g_enemyIndexByEntId[e.id] = g_enemies.size();
+            EnemyCold cold;
+            cold.runAnim = Animation_Load(SPRITE_ENEMY_RUN, 4, 0.25f);
+
+            g_enemyIndexByEntId[entId] = g_enemies.size();
             g_enemies.push_back(en);
+            g_enemyCold.push_back(std::move(cold));
 
             break;
         }
@@ -195,34 +200,10 @@ void Enemies_CreateBodies(EntitySystem* es, b2WorldId world, size_t startIndex)
 {
     if (!es) return;
 
-    for (size_t i = startIndex; i < es->pool.size(); ++i)
-    {
-        Entity& e = es->pool[i];
-        if (!e.active || e.kind != EntityKind::Enemy) continue;
-
-        // Create dynamic body
-        b2BodyDef bd = b2DefaultBodyDef();
-        bd.type = b2_dynamicBody;
-        bd.position = { PxToM(e.pos.x), PxToM(e.pos.y) };
-
-        b2BodyId body = b2CreateBody(world, &bd);
-
-        // Define shape
-        b2ShapeDef sd = b2DefaultShapeDef();
-        sd.density = 1.0f;
-        sd.filter.categoryBits = EnemyBit;
-        sd.filter.maskBits = AllBits;
-
-        b2Polygon box = b2MakeBox(PxToM(e.half.x), PxToM(e.half.y));
-        b2CreatePolygonShape(body, &sd, &box);
-
-        b2Body_EnableContactEvents(body, true);
-
-        // Register body with the physics system
-        Physics_RegisterBody(e, body);
-    }
+    const EntityKind enemy = EntityKind::Enemy;
+    Physics_CreateEntityBodies(es, world, (int32_t)startIndex, &enemy, BodyTemplate::Enemy);
 
-    TraceLog(LOG_INFO, "Created enemy bodies from index %zu to %zu", startIndex, es->pool.size());
+    TraceLog(LOG_INFO, "Created enemy bodies from index %zu to %zu", startIndex, es->id.size());
 }
 
 // Update enemies within the physics system.
@@ -236,98 +217,89 @@ void Enemies_Update(EntitySystem* es, const Grid* g, b2BodyId playerBody, float
     Vector2 playerPx = { MToPx(pM.x), MToPx(pM.y) };
     g_lastPlayerPos = playerPx;
 
-    const float repathEvery   = 0.35f;
     const float waypointReach = 8.0f;
     const float stopRadius    = 28.0f;
     const float chaseSpeed    = 40.0f;
     const float accelGain     = 4.0f;
     const float brakeGain     = 6.0f;
 
+    // One BFS per player tile change, shared by every enemy
+    if (g_pathMode == PathMode::FlowField)
+        FlowField_Update(&g_flowField, g, playerPx);
+
+    // Searches queued on earlier ticks, within this tick's budget
+    RepathContext repathCtx = { es, g, playerPx };
+    g_repath.batchSize = kRepathBatch;
+    Repath_Service(&g_repath, Enemy_RunRepathBatch, &repathCtx);
+
     for (size_t k = 0; k < g_enemies.size(); /* no ++ */)
     {
         Enemy& en = g_enemies[k];
 
-        // Resolve owning entity safely
-        Entity* e = Entities_Get(es, en.entId);
-        if (!e)
-        {
-            // Defensive: if entity no longer exists at all
-            size_t last = g_enemies.size() - 1;
-            if (k != last)
-            {
-                g_enemyIndexByEntId[g_enemies[last].entId] = k;
-                std::swap(g_enemies[k], g_enemies[last]);
-            }
-            g_enemyIndexByEntId.erase(en.entId);
-            g_enemies.pop_back();
-            continue;
-        }
-
-        // Handle inactive entity (probably queued for deletion)
-        if (!e->active)
+        // Resolve owning entity; drop enemies whose entity is gone or queued for deletion
+        const int32_t e = Entities_Index(es, en.entId);
+        if (e < 0)
         {
-            size_t last = g_enemies.size() - 1;
-            if (k != last)
-            {
-                g_enemyIndexByEntId[g_enemies[last].entId] = k;
-                std::swap(g_enemies[k], g_enemies[last]);
-            }
-            g_enemyIndexByEntId.erase(en.entId);
-            g_enemies.pop_back();
+            Enemies_RemoveAt(k);
             continue;
         }
 
         // Get Box2D body (skip if destroyed)
-        auto bIt = g_entityToBody.find(e->id);
-        if (bIt == g_entityToBody.end() || !b2Body_IsValid(bIt->second))
+        b2BodyId body = Physics_BodyOf(en.entId);
+        if (B2_IS_NULL(body) || !b2Body_IsValid(body))
         {
             k++;
             continue;
         }
-        b2BodyId body = bIt->second;
 
         if (en.health <= 0.f)
         {
-            Animation_Unload(&en.runAnim);
-            const int deadId = en.entId; // <-- capture before swap!
-            Physics_QueueDeletion(0, e->pos, e->id, e->kind);
+            Physics_QueueDeletion(0, es->pos[e], en.entId, es->kind[e]);
             g_enemiesKilled++;
-
-            // swap-erase safely
-            size_t last = g_enemies.size() - 1;
-            if (k != last)
-            {
-                g_enemyIndexByEntId[g_enemies[last].entId] = k;
-                std::swap(g_enemies[k], g_enemies[last]);
-            }
-
-            g_enemyIndexByEntId.erase(deadId);
-            g_enemies.pop_back();
+            Enemies_RemoveAt(k);
             continue;
         }
 
-
         b2Vec2 eM = b2Body_GetPosition(body);
         Vector2 posPx = { MToPx(eM.x), MToPx(eM.y) };
 
-        en.repathCd -= dt;
-        bool needPath = (en.repathCd <= 0.0f) || (en.waypoint >= (int)en.path.size());
         bool los = LineOfSightFloor(g, posPx, playerPx);
+        Vector2 target = playerPx;
 
-        if (needPath)
+        if (g_pathMode == PathMode::FlowField)
         {
-            en.repathCd = repathEvery;
-            en.path.clear();
-            en.waypoint = 0;
-            if (!los) AStar_FindPath(g, posPx, playerPx, en.path);
+            if (!los) FlowField_Sample(&g_flowField, posPx, &target);
         }
-
-        Vector2 target = playerPx;
-        if (!en.path.empty() && en.waypoint < (int)en.path.size())
+        else
         {
-            target = en.path[en.waypoint];
-            if (Vector2Distance(posPx, target) < waypointReach)
-                en.waypoint++;
+            en.repathCd -= dt;
+            const std::vector<Vector2>& path = g_enemyCold[k].path;
+            bool needPath = (en.repathCd <= 0.0f) || (en.waypoint >= (int)path.size());
+
+            if (needPath && !en.repathQueued)
+            {
+                if (los)
+                {
+                    // Straight chase, no search needed
+                    en.repathCd = kRepathEvery;
+                    g_enemyCold[k].path.clear();
+                    en.waypoint = 0;
+                }
+                else
+                {
+                    // Keep following the old path (or chase directly) until the search runs.
+                    // Closer enemies go first.
+                    Repath_Enqueue(&g_repath, en.entId, Vector2Distance(posPx, playerPx) / TILE_SIZE);
+                    en.repathQueued = true;
+                }
+            }
+
+            if (en.waypoint < (int)path.size())
+            {
+                target = path[en.waypoint];
+                if (Vector2Distance(posPx, target) < waypointReach)
+                    en.waypoint++;
+            }
         }
 
         float dToPlayer = Vector2Distance(posPx, playerPx);
@@ -346,11 +318,11 @@ void Enemies_Update(EntitySystem* es, const Grid* g, b2BodyId playerBody, float
 
         // visual feedback
         if (en.slowTimer > 0.0f)
-            e->color = (Color){120, 200, 255, 255};
+            es->color[e] = (Color){120, 200, 255, 255};
         else if (en.health < en.maxHealth * 0.5f)
-            e->color = (Color){255, 100, 100, 255};
+            es->color[e] = (Color){255, 100, 100, 255};
         else
-            e->color = GREEN;
+            es->color[e] = GREEN;
 
         if (dToPlayer < stopRadius * 2.0f)
         {
@@ -384,7 +356,7 @@ void Enemies_Update(EntitySystem* es, const Grid* g, b2BodyId playerBody, float
         
         Animation* currentAnim = nullptr;
         switch (en.animState) {
-            case EnemyAnimState::Run: currentAnim = &en.runAnim; break;
+            case EnemyAnimState::Run: currentAnim = &g_enemyCold[k].runAnim; break;
         }
         if(currentAnim) {
             currentAnim->flipped = !en.facingRight;
@@ -392,7 +364,7 @@ void Enemies_Update(EntitySystem* es, const Grid* g, b2BodyId playerBody, float
         }
         
         // sync position for renderer
-        e->pos = posPx;
+        es->pos[e] = posPx;
 
         k++; // advance loop
     }
@@ -400,52 +372,29 @@ void Enemies_Update(EntitySystem* es, const Grid* g, b2BodyId playerBody, float
 
 void Spawn_Corpse_Prop(EntitySystem* es, b2WorldId world, Vector2 pos)
 {
-    Entity corpse;
-    corpse.id = es->nextId++;
-    corpse.kind = EntityKind::Prop;
-    corpse.pos = pos;
-    corpse.half = { 6.0f, 6.0f };
-    corpse.color = BLACK;
-    corpse.active = true;
-    corpse.element = ElementType::NONE;
-    corpse.telekinetic = false;
-
-    es->pool.push_back(corpse);
-    Entity& e = es->pool.back(); // get reference to stored entity
-
-    // Create physical body
-    b2BodyDef bd = b2DefaultBodyDef();
-    bd.type = b2_dynamicBody;
-    bd.position = { PxToM(e.pos.x), PxToM(e.pos.y) };
-
-    b2BodyId body = b2CreateBody(world, &bd);
+    const Vector2 half = { 6.0f, 6.0f };
+    int corpseId = Entities_CreateBox(es, EntityKind::Prop, pos, half, BLACK);
+    if (!corpseId) return;
 
-    b2ShapeDef sd = b2DefaultShapeDef();
-    sd.density = 5.0f;
-    sd.filter.categoryBits = DynamicBit;
-    sd.filter.maskBits = AllBits;
-
-    b2Polygon box = b2MakeBox(PxToM(e.half.x), PxToM(e.half.y));
-    b2CreatePolygonShape(body, &sd, &box);
-
-    b2Body_EnableContactEvents(body, true);
-
-    // Register corpse body
-    Physics_RegisterBody(e, body);
+    // Physical body, registered with the corpse entity
+    const BodyTemplate tmpl = BodyTemplate::Corpse;
+    BodySpawnBatch batch = { &corpseId, &pos, &half, &tmpl, 1 };
+    Physics_CreateBodies(world, &batch);
 
     TraceLog(LOG_INFO, "🪦 Spawned corpse prop (Entity ID %d) at (%.1f, %.1f)",
-             e.id, e.pos.x, e.pos.y);
+             corpseId, pos.x, pos.y);
 }
 
-void Enemies_Draw(const EntitySystem* es) {
-    for (const Enemy& en : g_enemies) {
-        const Entity* e = Entities_Get((EntitySystem*)es, en.entId);
-        if (!e || !e->active) continue;
+void Enemies_Draw(const EntitySystem* es, const int32_t* enemies, int32_t count, float alpha) {
+    for (int32_t n = 0; n < count; ++n) {
+        const size_t k = (size_t)enemies[n];
+        const int32_t e = Entities_Index(es, g_enemies[k].entId);
+        if (e < 0) continue;
 
         const Animation* cur = nullptr;
-        switch (en.animState) {
-            case EnemyAnimState::Run: cur = &en.runAnim; break;
+        switch (g_enemies[k].animState) {
+            case EnemyAnimState::Run: cur = &g_enemyCold[k].runAnim; break;
         }
-        if (cur) Animation_Draw(cur, e->pos, 1.0f, WHITE);
+        if (cur) Animation_Draw(cur, Entities_RenderPos(es, e, alpha), 1.0f, WHITE);
     }
 }
@@ -4,38 +4,56 @@
 #include "../physics/physics.h"
 #include "../level/level.h"
 #include "../anims/animations.hpp"
+#include "../pathfinding/pathfinding.h"
+#include "../pathfinding/repath.h"
 #include "../../lib/box2d/include/box2d/box2d.h"
 #include <cstdint>
+#include <vector>
+#include <unordered_map>
 
 extern int g_enemiesKilled;
 extern int g_wave;
 extern float g_speedMultiplier;
+extern PathMode g_pathMode;   // how enemies path toward the player (toggle with P)
+extern RepathScheduler g_repath;
 
 enum class EnemyAnimState : uint8_t {Run};
 
+// Per-tick health and AI state; the steering loop walks this array
 struct Enemy {
     int entId = 0;
     float health = 0.0f;
     float maxHealth = 0.0f;
     float slowTimer = 0.0f;
 
-    Animation runAnim;
+    int waypoint = 0;
+    float repathCd = 0.0f;
+    bool repathQueued = false;   // waiting in g_repath
+    bool facingRight = true;
     EnemyAnimState animState = EnemyAnimState::Run;
-    bool facingRight;
+};
 
+// Bulky per-enemy data, parallel to g_enemies
+struct EnemyCold {
+    Animation runAnim;
     std::vector<Vector2> path;
-    int waypoint = 0;
-    float repathCd = 0.0f;
 };
 
 extern std::vector<Enemy> g_enemies;
+extern std::vector<EnemyCold> g_enemyCold;
 extern std::unordered_map<int, size_t> g_enemyIndexByEntId;
 
 void Enemies_Clear();
 Enemy* Enemy_FromEntityId(int entId);
+// Damages (and optionally slows) the enemy at dense index e; false if e isn't a live enemy
+bool Enemies_Damage(EntitySystem* es, int32_t e, float dmg, float slowSec, const char* tag);
+// Swap-removes enemy `index` from both arrays and unloads its animation
+void Enemies_RemoveAt(size_t index);
 void Enemies_Spawn(EntitySystem* es, const Grid* g, Vector2 playerPos, int count, float minDist);
 void Enemies_CreateBodies(EntitySystem* es, b2WorldId world, size_t startIndex);
 void Enemies_Update(EntitySystem* es, const Grid* g, b2BodyId playerBody, float dt);
+void Enemies_OnTilesChanged();   // the flow field is rebuilt on the next update
 void Spawn_Corpse_Prop(EntitySystem* es, b2WorldId world, Vector2 pos);
-void Enemies_Draw(const EntitySystem* es);
+// Draws the given g_enemies entries (usually the visible set)
+void Enemies_Draw(const EntitySystem* es, const int32_t* enemies, int32_t count, float alpha);
 
@@ -1,6 +1,8 @@
 #include "entity.hpp"
+#include "../memory/arena.h"
 #include <cmath>
 #include <algorithm>
+#include <ctime>
 
 // --- tiny RNG (xorshift32) -------------------------------------------------
 static uint32_t xr(uint32_t* s){ uint32_t x=*s; x^=x<<13; x^=x>>17; x^=x<<5; return *s=x; }
@@ -13,75 +15,157 @@ static inline bool aabb_overlap(Vector2 aPos, Vector2 aHalf, Vector2 bPos, Vecto
     std::fabs(aPos.y - bPos.y) <= (aHalf.y + bHalf.y);
 }
 
-// 3x3 all-floor clearance around tile (keeps props off walls/corridor edges)
-static bool has_clearance_1(const Grid* g, int tx, int ty){
-    for (int dy=-1; dy<=1; ++dy)
-        for (int dx=-1; dx<=1; ++dx){
-            Tile* t = grid_at((Grid*)g, tx+dx, ty+dy);
-            if (!t || t->id != TILE_FLOOR) return false;
-        }
-    return true;
+// --- internal lookup -------------------------------------------------------
+static int32_t find_by_id(const EntitySystem* es, int id){
+    if (id <= 0) return -1;
+    const uint32_t slot = EntityId_Slot(id);
+    if (slot >= es->slots.size()) return -1;
+    const EntitySlot& s = es->slots[slot];
+    if (s.generation != EntityId_Generation(id) || s.dense == UINT32_MAX) return -1;
+    return (es->flags[s.dense] & ENTITY_ACTIVE) ? (int32_t)s.dense : -1;
 }
 
-// --- internal lookup -------------------------------------------------------
-static Entity* find_by_id(EntitySystem* es, int id){
-    if (id <= 0) return nullptr;
-    for (auto& e : es->pool) if (e.id == id && e.active) return &e;
-    return nullptr;
+// Bumps the slot's generation and returns it to the free list. A slot whose generation
+// would overflow the id bits is retired instead of reused: generation 0 is never issued,
+// so no id (including the last one from this slot) matches it again.
+static void release_slot(EntitySystem* es, uint32_t slot){
+    EntitySlot& s = es->slots[slot];
+    if (s.generation >= ENTITY_GEN_MAX) {
+        s.generation = 0;
+        s.dense = UINT32_MAX;
+        return;
+    }
+    s.generation++;
+    s.dense = es->freeHead;
+    es->freeHead = slot;
 }
-static const Entity* find_by_id(const EntitySystem* es, int id){
-    if (id <= 0) return nullptr;
-    for (auto& e : es->pool) if (e.id == id && e.active) return &e;
-    return nullptr;
+
+static void clear_components(EntitySystem* es){
+    es->id.clear();
+    es->pos.clear();
+    es->half.clear();
+    es->kind.clear();
+    es->flags.clear();
+    es->prevPos.clear();
+    es->color.clear();
+    es->element.clear();
 }
 
 void Entities_Init(EntitySystem* es, uint32_t seed){
-    es->pool.clear();
-    es->nextId = 1;
+    clear_components(es);
+    SpatialHash_Clear(&es->spatial);
+    es->slots.clear();
+    es->freeHead = UINT32_MAX;
     es->seed = seed ? seed : (uint32_t)time(nullptr);
 }
 
 void Entities_Clear(EntitySystem* es){
-    es->pool.clear();
-    es->nextId = 1;
+    for (int id : es->id) release_slot(es, EntityId_Slot(id));
+    clear_components(es);
+    SpatialHash_Clear(&es->spatial);
 }
 
 int Entities_CreateBox(EntitySystem* es, EntityKind kind, Vector2 posPx, Vector2 halfPx, Color color){
-    Entity e;
-    e.id    = es->nextId++;
-    e.kind  = kind;
-    e.pos   = posPx;
-    e.half  = halfPx;
-    e.color = color;
-    e.active= true;
-    es->pool.emplace_back(e);
-    return e.id;
+    uint32_t slot = es->freeHead;
+    if (slot != UINT32_MAX) {
+        es->freeHead = es->slots[slot].dense;
+    } else {
+        slot = (uint32_t)es->slots.size();
+        if (slot > ENTITY_SLOT_MASK) return 0;
+        es->slots.push_back({ 0, 1 });
+    }
+    EntitySlot& s = es->slots[slot];
+    s.dense = (uint32_t)es->id.size();
+
+    const int id = (int)((s.generation << ENTITY_SLOT_BITS) | slot);
+    es->id.push_back(id);
+    es->pos.push_back(posPx);
+    es->half.push_back(halfPx);
+    es->kind.push_back(kind);
+    es->flags.push_back(ENTITY_ACTIVE);
+    es->prevPos.push_back(posPx);
+    es->color.push_back(color);
+    es->element.push_back(ElementType::NONE);
+    SpatialHash_Insert(&es->spatial, slot, posPx, halfPx);
+    return id;
 }
 
 void Entities_Destroy(EntitySystem* es, int id){
-    for (auto& e : es->pool){
-        if (e.id == id){
-            e.active = false;
-            break;
-        }
+    if (id <= 0) return;
+    const uint32_t slot = EntityId_Slot(id);
+    if (slot >= es->slots.size()) return;
+    const EntitySlot& s = es->slots[slot];
+    if (s.generation != EntityId_Generation(id) || s.dense == UINT32_MAX) return;
+
+    const uint32_t idx  = s.dense;
+    const uint32_t last = (uint32_t)es->id.size() - 1;
+    if (idx != last) {
+        es->id[idx]      = es->id[last];
+        es->pos[idx]     = es->pos[last];
+        es->half[idx]    = es->half[last];
+        es->kind[idx]    = es->kind[last];
+        es->flags[idx]   = es->flags[last];
+        es->prevPos[idx] = es->prevPos[last];
+        es->color[idx]   = es->color[last];
+        es->element[idx] = es->element[last];
+        es->slots[EntityId_Slot(es->id[idx])].dense = idx;
     }
-    es->pool.erase(std::remove_if(es->pool.begin(), es->pool.end(),
-                                  [](const Entity& E){ return !E.active; }),
-                   es->pool.end());
+    es->id.pop_back();
+    es->pos.pop_back();
+    es->half.pop_back();
+    es->kind.pop_back();
+    es->flags.pop_back();
+    es->prevPos.pop_back();
+    es->color.pop_back();
+    es->element.pop_back();
+    SpatialHash_Remove(&es->spatial, slot);
+    release_slot(es, slot);
 }
 
-Entity* Entities_Get(EntitySystem* es, int id){ return find_by_id(es, id); }
-const Entity* Entities_Get(const EntitySystem* es, int id){ return find_by_id(es, id); }
+int32_t Entities_Index(const EntitySystem* es, int id){ return find_by_id(es, id); }
+
+// Scratch for turning candidate slots into dense indices (queries run on the main thread)
+static std::vector<uint32_t> s_querySlots;
+
+void Entities_QueryRadius(const EntitySystem* es, Vector2 center, float radius, std::vector<int32_t>* out){
+    s_querySlots.clear();
+    SpatialHash_QueryRect(&es->spatial, v2(center.x - radius, center.y - radius),
+                          v2(center.x + radius, center.y + radius), &s_querySlots);
+    const float r2 = radius * radius;
+    for (uint32_t slot : s_querySlots){
+        const int32_t i = (int32_t)es->slots[slot].dense;
+        if (!(es->flags[i] & ENTITY_ACTIVE)) continue;
+        const float dx = es->pos[i].x - center.x, dy = es->pos[i].y - center.y;
+        if (dx*dx + dy*dy <= r2) out->push_back(i);
+    }
+}
+
+void Entities_QueryAABB(const EntitySystem* es, Vector2 center, Vector2 half, std::vector<int32_t>* out){
+    s_querySlots.clear();
+    SpatialHash_QueryRect(&es->spatial, v2(center.x - half.x, center.y - half.y),
+                          v2(center.x + half.x, center.y + half.y), &s_querySlots);
+    for (uint32_t slot : s_querySlots){
+        const int32_t i = (int32_t)es->slots[slot].dense;
+        if (!(es->flags[i] & ENTITY_ACTIVE)) continue;
+        if (aabb_overlap(center, half, es->pos[i], es->half[i])) out->push_back(i);
+    }
+}
 
 
-void Entities_Draw(const EntitySystem* es){
-    for (const auto& e : es->pool){
-        if (!e.active) continue;
-        if (e.kind != EntityKind::Prop) continue;
+void Entities_BeginTick(EntitySystem* es){
+    std::copy(es->pos.begin(), es->pos.end(), es->prevPos.begin());
+}
+
+void Entities_Draw(const EntitySystem* es, const int32_t* dense, int32_t count, float alpha){
+    for (int32_t k = 0; k < count; ++k){
+        const int32_t i = dense[k];
+        if (!(es->flags[i] & ENTITY_ACTIVE)) continue;
+        if (es->kind[i] != EntityKind::Prop) continue;
+        const Vector2 p = Entities_RenderPos(es, i, alpha), h = es->half[i];
         DrawRectangleV(
-            v2(e.pos.x - e.half.x, e.pos.y - e.half.y),
-            v2(e.half.x*2.f,       e.half.y*2.f),
-            e.color
+            v2(p.x - h.x,  p.y - h.y),
+            v2(h.x*2.f,    h.y*2.f),
+            es->color[i]
         );
     }
 }
@@ -98,16 +182,19 @@ int Entities_SpawnBoxesInLevel(EntitySystem* es,
 
     uint32_t rng = seed ? seed : es->seed;
 
-    // Collect candidate floor tiles with 1-tile clearance
-    std::vector<int> candidates;
-    candidates.reserve(g->w * g->h);
-    for (int y=0; y<g->h; ++y)
-        for (int x=0; x<g->w; ++x){
-            Tile* t = grid_at((Grid*)g, x, y);
-            if (t && t->id == TILE_FLOOR && has_clearance_1(g,x,y)){
-                candidates.push_back(y*g->w + x);
-            }
-        }
+    // Collect candidate floor tiles with a 3x3 all-floor clearance (keeps props off
+    // walls/corridor edges), a row of walkability words at a time. Level scratch, gone on
+    // the next level.
+    ArenaVector<int>      candidates{ ArenaAllocator<int>(&g_levelArena) };
+    ArenaVector<uint64_t> clear{ ArenaAllocator<uint64_t>(&g_levelArena) };
+    candidates.reserve((size_t)g->w * g->h);
+    clear.resize((size_t)g->walkStride);
+    for (int y=0; y<g->h; ++y){
+        grid_walk_clearance_row(g, y, 1, clear.data());
+        for (int j=0; j<g->walkStride; ++j)
+            for (uint64_t bits = clear[j]; bits; bits &= bits - 1)
+                candidates.push_back(y*g->w + walk_bit_x(j, walk_ctz(bits)));
+    }
     if (candidates.empty()) return 0;
 
     // Choose target count
@@ -120,6 +207,7 @@ int Entities_SpawnBoxesInLevel(EntitySystem* es,
     }
 
     // Spawn up to 'target' boxes, avoid overlapping previously spawned boxes
+    std::vector<int32_t> overlaps;
     int spawned = 0;
     for (int i=0; i<(int)candidates.size() && spawned < target; ++i){
         int idx = candidates[i];
@@ -129,12 +217,9 @@ int Entities_SpawnBoxesInLevel(EntitySystem* es,
                            ty * (float)TILE_SIZE + TILE_SIZE*0.5f);
 
         // Avoid overlapping any existing entity AABBs
-        bool overlaps = false;
-        for (const auto& e : es->pool){
-            if (!e.active) continue;
-            if (aabb_overlap(posPx, halfPx, e.pos, e.half)){ overlaps = true; break; }
-        }
-        if (overlaps) continue;
+        overlaps.clear();
+        Entities_QueryAABB(es, posPx, halfPx, &overlaps);
+        if (!overlaps.empty()) continue;
 
         Entities_CreateBox(es, EntityKind::Prop, posPx, halfPx, BLACK);
         ++spawned;
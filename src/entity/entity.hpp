@@ -1,6 +1,7 @@
 #pragma once
 #include "raylib.h"
 #include "../level/level.h"
+#include "spatial_hash.hpp"
 #include <cstdint>
 #include <vector>
 
@@ -17,36 +18,78 @@ enum class ElementType {
     ICE
 };
 
-struct Entity {
-    int id;
-    EntityKind kind;
-    Vector2 pos;
-    Vector2 half;
-    Color color;
-    bool active;
+enum EntityFlags : uint8_t {
+    ENTITY_ACTIVE      = 1 << 0,
+    ENTITY_TELEKINETIC = 1 << 1,   // currently held
+};
+
+// Entity ids are generational handles: the low bits pick a slot, the high bits hold that
+// slot's generation. Destroying an entity bumps the generation, so old ids stop resolving
+// instead of aliasing whatever reuses the slot. Ids are always > 0.
+#define ENTITY_SLOT_BITS 20
+#define ENTITY_SLOT_MASK ((1u << ENTITY_SLOT_BITS) - 1u)
+#define ENTITY_GEN_MAX   ((1u << (31 - ENTITY_SLOT_BITS)) - 1u)
+
+static inline uint32_t EntityId_Slot(int id)       { return (uint32_t)id & ENTITY_SLOT_MASK; }
+static inline uint32_t EntityId_Generation(int id) { return (uint32_t)id >> ENTITY_SLOT_BITS; }
 
-    ElementType element = ElementType::NONE;   // what element it carries
-    bool telekinetic = false;                  // whether currently held
+struct EntitySlot {
+    uint32_t dense;       // component index while alive, next free slot otherwise
+    uint32_t generation;  // 1..ENTITY_GEN_MAX, 0 once the slot is retired
 };
 
-// Simple container
+// Slot map over structure-of-arrays components. Index i of every array is the same entity;
+// the arrays stay dense (swap-removed on destroy) and slots map ids to an index. Systems
+// walk only the arrays they need, e.g. the position sync touches id/flags/pos.
 struct EntitySystem {
-    std::vector<Entity> pool;  // packed (inactive removed on destroy)
-    int        nextId{1};
+    // hot
+    std::vector<int>         id;
+    std::vector<Vector2>     pos;
+    std::vector<Vector2>     half;
+    std::vector<EntityKind>  kind;
+    std::vector<uint8_t>     flags;     // EntityFlags
+    // render
+    std::vector<Vector2>     prevPos;   // pos at the start of the current tick
+    // cold
+    std::vector<Color>       color;
+    std::vector<ElementType> element;   // what element it carries
+
+    std::vector<EntitySlot> slots;
+    SpatialHash             spatial;   // by slot, kept current by Entities_Update
+    uint32_t   freeHead{UINT32_MAX};
     uint32_t   seed{0};        // for deterministic spawns
 };
 
 
-// Init / clear
+// Init / clear. Clear keeps the slot table so ids from before it stay stale.
 void Entities_Init(EntitySystem* es, uint32_t seed);
 void Entities_Clear(EntitySystem* es);
 
+// Index/create/destroy are O(1). Destroy moves the last entity into the freed spot, so it
+// invalidates component indices (but not ids).
+
 int         Entities_CreateBox(EntitySystem* es, EntityKind kind, Vector2 posPx, Vector2 halfPx, Color color);
 void        Entities_Destroy(EntitySystem* es, int id);
-Entity*     Entities_Get(EntitySystem* es, int id);
-const Entity*Entities_Get(const EntitySystem* es, int id);
+int32_t     Entities_Index(const EntitySystem* es, int id);   // -1 if gone or inactive
+
+static inline int32_t Entities_Count(const EntitySystem* es) { return (int32_t)es->id.size(); }
+
+// Dense indices of active entities whose center lies within radius of center
+void Entities_QueryRadius(const EntitySystem* es, Vector2 center, float radius, std::vector<int32_t>* out);
+// Dense indices of active entities whose AABB overlaps the box at center +- half
+void Entities_QueryAABB(const EntitySystem* es, Vector2 center, Vector2 half, std::vector<int32_t>* out);
+
+// Copies pos into prevPos; call once at the start of each tick
+void Entities_BeginTick(EntitySystem* es);
+
+// Draws the given props (dense indices, usually the visible set)
+// alpha in [0,1] blends from prevPos (0) to pos (1)
+void Entities_Draw(const EntitySystem* es, const int32_t* dense, int32_t count, float alpha);
 
-void Entities_Draw(const EntitySystem* es);
+static inline Vector2 Entities_RenderPos(const EntitySystem* es, int32_t i, float alpha) {
+    const Vector2 a = es->prevPos[i], b = es->pos[i];
+    return { a.x + (b.x - a.x) * alpha, a.y + (b.y - a.y) * alpha };
+}
 
 // Returns how many spawned. Ensures tiles are floor and provides a small spacing check.
 int Entities_SpawnBoxesInLevel(EntitySystem* es,
@@ -0,0 +1,104 @@
+#include "spatial_hash.hpp"
+#include <cmath>
+#include <algorithm>
+
+static const uint32_t kMinBuckets = 1024;
+
+static inline int32_t CellOf(float px) {
+    return (int32_t)std::floor(px / (float)SPATIAL_CELL_SIZE);
+}
+
+static inline uint32_t BucketOf(const SpatialHash* sh, int32_t cx, int32_t cy) {
+    uint32_t h = ((uint32_t)cx * 73856093u) ^ ((uint32_t)cy * 19349663u);
+    return h & (uint32_t)(sh->heads.size() - 1);
+}
+
+static void Link(SpatialHash* sh, uint32_t slot, uint32_t bucket) {
+    SpatialNode& n = sh->nodes[slot];
+    n.bucket = bucket;
+    n.prev = SPATIAL_NONE;
+    n.next = sh->heads[bucket];
+    if (n.next != SPATIAL_NONE) sh->nodes[n.next].prev = slot;
+    sh->heads[bucket] = slot;
+}
+
+static void Unlink(SpatialHash* sh, uint32_t slot) {
+    SpatialNode& n = sh->nodes[slot];
+    if (n.prev != SPATIAL_NONE) sh->nodes[n.prev].next = n.next;
+    else                        sh->heads[n.bucket] = n.next;
+    if (n.next != SPATIAL_NONE) sh->nodes[n.next].prev = n.prev;
+    n.next = n.prev = SPATIAL_NONE;
+    n.bucket = SPATIAL_NONE;
+}
+
+// Keeps the load factor at or below one entity per bucket
+static void Grow(SpatialHash* sh, uint32_t want) {
+    uint32_t size = sh->heads.empty() ? kMinBuckets : (uint32_t)sh->heads.size();
+    while (size < want) size *= 2;
+    if (size == sh->heads.size()) return;
+
+    sh->heads.assign(size, SPATIAL_NONE);
+    for (uint32_t s = 0; s < sh->nodes.size(); ++s) {
+        SpatialNode& n = sh->nodes[s];
+        if (n.bucket == SPATIAL_NONE) continue;
+        Link(sh, s, BucketOf(sh, n.cx, n.cy));
+    }
+}
+
+void SpatialHash_Clear(SpatialHash* sh) {
+    std::fill(sh->heads.begin(), sh->heads.end(), SPATIAL_NONE);
+    std::fill(sh->nodes.begin(), sh->nodes.end(), SpatialNode{});
+    sh->maxHalf = 0.0f;
+    sh->count = 0;
+}
+
+void SpatialHash_Insert(SpatialHash* sh, uint32_t slot, Vector2 pos, Vector2 half) {
+    if (slot >= sh->nodes.size()) sh->nodes.resize(slot + 1);
+    if (sh->nodes[slot].bucket != SPATIAL_NONE) SpatialHash_Remove(sh, slot);
+    Grow(sh, sh->count + 1);
+
+    SpatialNode& n = sh->nodes[slot];
+    n.cx = CellOf(pos.x);
+    n.cy = CellOf(pos.y);
+    Link(sh, slot, BucketOf(sh, n.cx, n.cy));
+
+    sh->maxHalf = std::max(sh->maxHalf, std::max(half.x, half.y));
+    sh->count++;
+}
+
+void SpatialHash_Remove(SpatialHash* sh, uint32_t slot) {
+    if (slot >= sh->nodes.size() || sh->nodes[slot].bucket == SPATIAL_NONE) return;
+    Unlink(sh, slot);
+    sh->count--;
+}
+
+void SpatialHash_Move(SpatialHash* sh, uint32_t slot, Vector2 pos) {
+    if (slot >= sh->nodes.size()) return;
+    SpatialNode& n = sh->nodes[slot];
+    if (n.bucket == SPATIAL_NONE) return;
+
+    const int32_t cx = CellOf(pos.x), cy = CellOf(pos.y);
+    if (cx == n.cx && cy == n.cy) return;
+
+    Unlink(sh, slot);
+    n.cx = cx;
+    n.cy = cy;
+    Link(sh, slot, BucketOf(sh, cx, cy));
+}
+
+void SpatialHash_QueryRect(const SpatialHash* sh, Vector2 mn, Vector2 mx, std::vector<uint32_t>* outSlots) {
+    if (sh->count == 0) return;
+
+    const int32_t x0 = CellOf(mn.x - sh->maxHalf), x1 = CellOf(mx.x + sh->maxHalf);
+    const int32_t y0 = CellOf(mn.y - sh->maxHalf), y1 = CellOf(mx.y + sh->maxHalf);
+
+    for (int32_t cy = y0; cy <= y1; ++cy)
+        for (int32_t cx = x0; cx <= x1; ++cx) {
+            // Other cells can share the bucket; only take this cell's entries so nothing is
+            // reported twice
+            for (uint32_t s = sh->heads[BucketOf(sh, cx, cy)]; s != SPATIAL_NONE; s = sh->nodes[s].next) {
+                const SpatialNode& n = sh->nodes[s];
+                if (n.cx == cx && n.cy == cy) outSlots->push_back(s);
+            }
+        }
+}
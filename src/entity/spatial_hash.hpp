@@ -0,0 +1,36 @@
+#pragma once
+#include "raylib.h"
+#include "../level/level.h"
+#include <cstdint>
+#include <vector>
+
+// Uniform-grid spatial hash over entity slots. Each entity sits in the cell holding its
+// center; cells hash into a power-of-two bucket table with intrusive doubly linked lists,
+// so the world needs no fixed bounds and moving within a cell costs nothing. Queries return
+// candidates from the covered cells (widened by the largest half extent seen), which the
+// caller filters exactly.
+
+#define SPATIAL_CELL_SIZE (TILE_SIZE * 2)
+#define SPATIAL_NONE      UINT32_MAX
+
+struct SpatialNode {
+    uint32_t next   = SPATIAL_NONE;
+    uint32_t prev   = SPATIAL_NONE;
+    uint32_t bucket = SPATIAL_NONE;   // SPATIAL_NONE while not inserted
+    int32_t  cx = 0, cy = 0;
+};
+
+struct SpatialHash {
+    std::vector<uint32_t>    heads;   // bucket -> first slot
+    std::vector<SpatialNode> nodes;   // by entity slot
+    float    maxHalf = 0.0f;
+    uint32_t count   = 0;
+};
+
+void SpatialHash_Clear(SpatialHash* sh);
+void SpatialHash_Insert(SpatialHash* sh, uint32_t slot, Vector2 pos, Vector2 half);
+void SpatialHash_Remove(SpatialHash* sh, uint32_t slot);
+void SpatialHash_Move(SpatialHash* sh, uint32_t slot, Vector2 pos);
+
+// Appends the slots of every entity whose cell could overlap [mn, mx]
+void SpatialHash_QueryRect(const SpatialHash* sh, Vector2 mn, Vector2 mx, std::vector<uint32_t>* outSlots);
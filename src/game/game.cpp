@@ -0,0 +1,250 @@
+#include "game.h"
+#include "../physics/physics.h"
+#include "../physics/contacts.h"
+#include "../player/projectile.h"
+#include "../entity/enemies.hpp"
+#include "../pathfinding/pathfinding.h"
+#include "../memory/arena.h"
+#include "../state.h"
+#include <chrono>
+#include <cmath>
+
+typedef std::chrono::steady_clock Clock;
+
+static const char* kTimerNames[GT_COUNT] = {
+    "player", "enemies", "physics", "contacts", "projectiles", "entities", "waves", "deletions"
+};
+
+const char* GameTimer_Name(int timer) {
+    return (timer >= 0 && timer < GT_COUNT) ? kTimerNames[timer] : "?";
+}
+
+// Adds the time since the last mark to `timer`
+struct StepTimer {
+    GameProfile*      profile;
+    Clock::time_point last;
+
+    void Mark(GameTimer timer) {
+        Clock::time_point now = Clock::now();
+        double us = std::chrono::duration<double, std::micro>(now - last).count();
+        profile->totalUs[timer] += us;
+        if (us > profile->maxUs[timer]) profile->maxUs[timer] = us;
+        last = now;
+    }
+};
+
+int FixedStep_Advance(FixedStep* fs, float frameDt, float tick) {
+    if (frameDt < 0.0f) frameDt = 0.0f;
+    fs->accumulator += frameDt;
+
+    int steps = (int)(fs->accumulator / tick);
+    if (steps > fs->maxSteps) {
+        // Too far behind (breakpoint, window drag, slow frame): run the clamp and drop the
+        // rest rather than spiral into ever longer frames
+        fs->dropped += steps - fs->maxSteps;
+        steps = fs->maxSteps;
+        fs->accumulator = std::fmod(fs->accumulator, tick);
+    } else {
+        fs->accumulator -= steps * tick;
+    }
+    return steps;
+}
+
+float FixedStep_Alpha(const FixedStep* fs, float tick) {
+    float a = fs->accumulator / tick;
+    return a < 0.0f ? 0.0f : (a > 1.0f ? 1.0f : a);
+}
+
+static void SpawnStartingEntities(Game* game, int enemyCount, float minDist) {
+    // Props / boxes
+    Entities_SpawnBoxesInLevel(&game->ents, &game->grid, game->config.minProps, game->config.maxProps,
+                               (Vector2){10.f, 10.f}, 0);
+    Create_Entity_Bodies(&game->ents, game->world);
+
+    // Enemies
+    const size_t prevCount = (size_t)Entities_Count(&game->ents);
+    Enemies_Spawn(&game->ents, &game->grid, game->player.pos, enemyCount, minDist);
+    Enemies_CreateBodies(&game->ents, game->world, prevCount);
+}
+
+void Game_Init(Game* game, const GameConfig* config) {
+    game->config  = config ? *config : GameConfig{};
+    game->profile = GameProfile{};
+
+    // Same seed -> same level, spawns and scripted run
+    const uint32_t seed = game->config.seed;
+    if (seed) SetRandomSeed(seed);
+
+    // Level scratch is sized for the statics builder, the largest user; the frame arena
+    // regrows itself if a tick ever needs more
+    const size_t tiles = (size_t)(game->config.levelW + 1) * (game->config.levelH + 1);
+    if (!g_frameArena.base) Arena_Init(&g_frameArena, "frame", 64 * 1024);
+    if (!g_levelArena.base) Arena_Init(&g_levelArena, "level", tiles * 32);
+    Arena_Reset(&g_levelArena);
+
+    grid_init(&game->grid, game->config.levelW, game->config.levelH);
+
+    LevelGenParams params = level_gen_params(game->config.levelW, game->config.levelH, seed);
+    gen_level(&game->grid, &params);
+    Pathfinding_SetLevel(&game->grid);
+
+    Entities_Init(&game->ents, seed);
+
+    // INIT PHYSICS
+    game->world = InitWorld();
+    BuildStaticsFromGrid(game->world, &game->grid);
+    Projectile_InitPool(game->world, PROJECTILE_POOL_INITIAL);
+
+    Player_Init(&game->player, &game->grid);
+    CreatePlayer(game->world, game->player.pos, 12.0f, 12.0f); // linear damping default
+
+    SpawnStartingEntities(game, game->config.startEnemies, 300.0f);
+
+    TraceLog(LOG_INFO, "WORLD BUILT SETUP COMPLETE: entities=%zu enemies=%zu bodies=%u",
+             (size_t)Entities_Count(&game->ents), g_enemies.size(),
+             g_bodyLinks.count);
+}
+
+void Game_Shutdown(Game* game) {
+    if (b2World_IsValid(game->world)) DestroyWorld(game->world);
+    Physics_ClearBodies();
+    grid_free(&game->grid);
+    Player_Unload(&game->player);
+    Enemies_Clear();
+    Entities_Clear(&game->ents);
+    Projectile_Clear();
+    Arena_Free(&g_frameArena);
+    Arena_Free(&g_levelArena);
+}
+
+void Game_Restart(Game* game, bool rebuildWorld) {
+    Enemies_Clear();
+    Arena_Reset(&g_levelArena);
+
+    g_enemiesKilled = 0;
+    g_wave = 0;
+    g_speedMultiplier = 1.0f;
+    g_lastWaveSpawned = 0;
+
+    if (rebuildWorld || !b2World_IsValid(game->world)) {
+        if (b2World_IsValid(game->world)) {
+            b2DestroyWorld(game->world);
+        }
+
+        game->world = InitWorld();
+        BuildStaticsFromGrid(game->world, &game->grid);
+        Projectile_InitPool(game->world, PROJECTILE_POOL_INITIAL);
+
+        // Entity <-> body links
+        Physics_ClearBodies();
+    } else {
+        // The wall chains follow the grid (Game_SetTiles keeps them in step), so they and the
+        // world's allocations stay.
+        // Entity and player bodies go; projectiles go back to their pool.
+        Physics_DestroyEntityBodies();
+        if (b2Body_IsValid(g_playerBody)) b2DestroyBody(g_playerBody);
+        Projectile_ReleaseAll();
+    }
+    Entities_Clear(&game->ents);
+
+    Player_Unload(&game->player);
+    Player_Init(&game->player, &game->grid);
+    CreatePlayer(game->world, game->player.pos, 12.0f, 12.0f, 6.0f);
+
+    SpawnStartingEntities(game, 6, 150.0f);
+
+    TraceLog(LOG_INFO, "Restart: entities=%zu enemies=%zu bodies=%u",
+             (size_t)Entities_Count(&game->ents), g_enemies.size(),
+             g_bodyLinks.count);
+
+    game->player.cam.target = game->player.pos;
+    game->player.prevPos = game->player.pos;
+
+    g_gameOver = false;
+}
+
+int Game_SetTiles(Game* game, int x, int y, int w, int h, uint8_t id, uint8_t flags) {
+    grid_set_rect(&game->grid, x, y, w, h, id, flags);
+    const int chunks = Physics_UpdateTiles(game->world, &game->grid, x, y, w, h);
+    Pathfinding_SetLevel(&game->grid);
+    Enemies_OnTilesChanged();
+    return chunks;
+}
+
+static void SpawnWave(Game* game, Vector2 playerPosPx) {
+    g_wave++;
+    g_lastWaveSpawned = g_enemiesKilled / 2;
+
+    g_speedMultiplier += 0.05f;
+    int spawnCount = 4;
+
+    TraceLog(LOG_INFO, "Wave %d triggered! Kills=%d Speed x%.2f",
+             g_wave, g_enemiesKilled, g_speedMultiplier);
+
+    const size_t prevCountWave = (size_t)Entities_Count(&game->ents);
+    Enemies_Spawn(&game->ents, &game->grid, playerPosPx, spawnCount, 700.0f);
+    Enemies_CreateBodies(&game->ents, game->world, prevCountWave);
+
+    TraceLog(LOG_INFO, "Wave spawn: entities=%zu enemies=%zu bodies=%u",
+             (size_t)Entities_Count(&game->ents), g_enemies.size(),
+             g_bodyLinks.count);
+}
+
+void Game_Step(Game* game, const SimInput* in, float dt) {
+    Player& player = game->player;
+    StepTimer timer = { &game->profile, Clock::now() };
+
+    Entities_BeginTick(&game->ents);
+    player.prevPos = player.pos;
+
+    UpdatePlayer(&player, g_playerBody, dt, in->move, 125.0f);
+
+    if (in->holdTelekinesis) {
+        Telekinesis_Hold(player.pos, 50.0f, teleForce, &game->ents);
+    } else if (in->releaseTelekinesis) {
+        Telekinesis_Fire(player.pos, 50.0f, 500.0f, &game->ents);
+    }
+
+    if (in->cyclePathMode) {
+        g_pathMode = PathMode_Next(g_pathMode);
+        TraceLog(LOG_INFO, "Enemy pathing: %s", PathMode_Name(g_pathMode));
+    }
+
+    if (in->selectProjectile >= 0) g_currentProjectile = (ProjectileType)in->selectProjectile;
+    if (in->fire) Projectile_Shoot(game->world, player.pos, in->aimWorld);
+    timer.Mark(GT_PLAYER);
+
+    Enemies_Update(&game->ents, &game->grid, g_playerBody, dt);
+    timer.Mark(GT_ENEMIES);
+
+    b2World_Step(game->world, dt, subSteps);
+    timer.Mark(GT_PHYSICS);
+
+    Contacts_Dispatch(game->world, &game->ents);
+    timer.Mark(GT_CONTACTS);
+
+    Projectile_Update(dt);
+    timer.Mark(GT_PROJECTILES);
+
+    Entities_Update(&game->ents, dt);
+
+    // Sync player camera
+    Vector2 playerPosPx = GetPlayerPixels(g_playerBody);
+    player.pos = playerPosPx;
+    player.cam.target = playerPosPx;
+    timer.Mark(GT_ENTITIES);
+
+    // Spawn waves
+    if (g_enemiesKilled / 2 > g_lastWaveSpawned)
+        SpawnWave(game, playerPosPx);
+    timer.Mark(GT_WAVES);
+
+    // Ensure deletions get flushed AFTER creations
+    Physics_FlushDeletions(game->world, &game->ents);
+    timer.Mark(GT_DELETIONS);
+
+    // Nothing allocated this tick outlives it
+    Arena_Reset(&g_frameArena);
+
+    game->profile.ticks++;
+}
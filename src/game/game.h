@@ -0,0 +1,90 @@
+#pragma once
+#include "raylib.h"
+#include "../level/level.h"
+#include "../entity/entity.hpp"
+#include "../player/player.h"
+#include "../../lib/box2d/include/box2d/box2d.h"
+#include <cstdint>
+
+// The simulation half of the game: level, physics world, entities and the per-tick update,
+// with no window, input polling or drawing. main.cpp feeds it keyboard/mouse input and
+// renders it; the headless SpellForgeSim target feeds it scripted input.
+
+// Everything the player can do during one tick
+struct SimInput {
+    Vector2 move;               // raw WASD direction, normalized by the player update
+    Vector2 aimWorld;           // projectile target in world pixels
+    bool    fire;
+    bool    holdTelekinesis;
+    bool    releaseTelekinesis;
+    int8_t  selectProjectile;   // ProjectileType to switch to, -1 to keep the current one
+    bool    cyclePathMode;
+};
+
+// Per-subsystem timers, in Game_Step order
+enum GameTimer {
+    GT_PLAYER,
+    GT_ENEMIES,
+    GT_PHYSICS,
+    GT_CONTACTS,
+    GT_PROJECTILES,
+    GT_ENTITIES,
+    GT_WAVES,
+    GT_DELETIONS,
+    GT_COUNT
+};
+
+struct GameProfile {
+    double   totalUs[GT_COUNT] = {};
+    double   maxUs[GT_COUNT]   = {};
+    uint64_t ticks = 0;
+};
+
+struct GameConfig {
+    uint32_t seed         = 0;    // 0 -> time-based, as before
+    int      levelW       = 80;
+    int      levelH       = 45;
+    int      startEnemies = 10;
+    int      minProps     = 10;
+    int      maxProps     = 20;
+};
+
+struct Game {
+    GameConfig   config;
+    Grid         grid;
+    EntitySystem ents;
+    Player       player;
+    b2WorldId    world;
+    GameProfile  profile;
+};
+
+// Fixed-timestep accumulator: frame time goes in, whole ticks come out, and the remainder
+// becomes the interpolation factor for rendering between the last two tick states.
+struct FixedStep {
+    float accumulator = 0.0f;
+    int   maxSteps    = 5;      // per frame; older backlog is dropped instead of chased
+    int   dropped     = 0;      // ticks dropped because of the clamp, for diagnostics
+};
+
+// Returns how many ticks to run for a frame that took frameDt seconds
+int   FixedStep_Advance(FixedStep* fs, float frameDt, float tick);
+// Blend factor in [0,1) between the previous and the current tick
+float FixedStep_Alpha(const FixedStep* fs, float tick);
+
+void Game_Init(Game* game, const GameConfig* config);
+void Game_Shutdown(Game* game);
+
+// Starts over on the same level after a game over. By default the Box2D world and its wall
+// colliders are kept and only the dynamic bodies go; rebuildWorld recreates it all.
+void Game_Restart(Game* game, bool rebuildWorld = false);
+
+// Sets the tiles in [x, x+w) x [y, y+h) and refreshes what is derived from them: walk bits,
+// the wall colliders of the chunks around the edit, and the path data. Returns the number
+// of collider chunks rebuilt. Call between ticks.
+int  Game_SetTiles(Game* game, int x, int y, int w, int h, uint8_t id, uint8_t flags);
+
+// One fixed tick of gameplay. Saves the previous positions first, so rendering can
+// interpolate between the two most recent ticks.
+void Game_Step(Game* game, const SimInput* input, float dt);
+
+const char* GameTimer_Name(int timer);
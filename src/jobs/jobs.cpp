@@ -0,0 +1,227 @@
+#include "jobs.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+JobSystem* g_jobs = nullptr;
+
+static const uint32_t kQueueCapacity = 1024;   // ranges per worker queue, power of two
+
+struct JobTask {
+    JobRangeFn           fn = nullptr;
+    void*                ctx = nullptr;
+    std::atomic<int32_t> remaining{0};   // ranges not finished yet
+    int32_t              chunk = 0;
+    int32_t              deferredEnd = 0; // [0, deferredEnd) didn't fit in the queue; Jobs_Wait runs it
+};
+
+struct JobItem {
+    JobTask* task;
+    int32_t  begin, end;
+};
+
+// Ring of ranges: the owner pushes and pops at the tail, thieves take from the head
+struct WorkQueue {
+    std::mutex mutex;
+    JobItem    items[kQueueCapacity];
+    uint32_t   head = 0, tail = 0;
+};
+
+struct JobSystem {
+    std::vector<std::thread>     threads;
+    std::unique_ptr<WorkQueue[]> queues;   // one per worker
+    int                          workers = 1;
+
+    std::mutex              sleepMutex;
+    std::condition_variable wake;          // new ranges, a finished task, or quit
+    std::atomic<int32_t>    queued{0};     // ranges sitting in any queue
+    bool                    quit = false;
+
+    std::mutex taskMutex;
+    JobTask    tasks[JOBS_MAX_TASKS];
+    int32_t    freeTasks[JOBS_MAX_TASKS];
+    int32_t    freeCount = 0;
+};
+
+// Worker index of the calling thread; anything outside the pool counts as worker 0
+static thread_local const JobSystem* t_pool = nullptr;
+static thread_local uint32_t         t_worker = 0;
+
+static uint32_t Self(const JobSystem* js) {
+    return t_pool == js ? t_worker : 0;
+}
+
+static bool PushBack(WorkQueue& q, const JobItem& item) {
+    if (q.tail - q.head == kQueueCapacity) return false;
+    q.items[q.tail++ & (kQueueCapacity - 1)] = item;
+    return true;
+}
+
+static bool PopBack(WorkQueue& q, JobItem* out) {
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.tail == q.head) return false;
+    *out = q.items[--q.tail & (kQueueCapacity - 1)];
+    return true;
+}
+
+static bool PopFront(WorkQueue& q, JobItem* out) {
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.tail == q.head) return false;
+    *out = q.items[q.head++ & (kQueueCapacity - 1)];
+    return true;
+}
+
+static void RunItem(JobSystem* js, const JobItem& item, uint32_t worker) {
+    item.task->fn(item.begin, item.end, worker, item.task->ctx);
+    // The waiter may free the task as soon as this hits zero; don't touch it after
+    if (item.task->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        { std::lock_guard<std::mutex> lock(js->sleepMutex); }
+        js->wake.notify_all();
+    }
+}
+
+// Own queue newest-first, then steal the oldest range from the next non-empty queue
+static bool TryRunOne(JobSystem* js, uint32_t worker) {
+    if (js->queued.load(std::memory_order_acquire) <= 0) return false;
+
+    JobItem item;
+    bool found = PopBack(js->queues[worker], &item);
+    for (int k = 1; !found && k < js->workers; ++k)
+        found = PopFront(js->queues[(worker + k) % js->workers], &item);
+    if (!found) return false;
+
+    js->queued.fetch_sub(1, std::memory_order_relaxed);
+    RunItem(js, item, worker);
+    return true;
+}
+
+static void WorkerMain(JobSystem* js, uint32_t worker) {
+    t_pool   = js;
+    t_worker = worker;
+    for (;;) {
+        if (TryRunOne(js, worker)) continue;
+
+        std::unique_lock<std::mutex> lock(js->sleepMutex);
+        js->wake.wait(lock, [&]{ return js->quit || js->queued.load(std::memory_order_acquire) > 0; });
+        if (js->quit) return;
+    }
+}
+
+JobSystem* Jobs_Create(int threadCount) {
+    if (threadCount <= 0) threadCount = (int)std::thread::hardware_concurrency();
+    if (threadCount <= 0) threadCount = 1;
+#if defined(PLATFORM_WEB)
+    threadCount = 1;   // the web build has no pthreads; run everything inline
+#endif
+
+    JobSystem* js = new JobSystem();
+    js->workers = threadCount;
+    js->queues.reset(new WorkQueue[threadCount]);
+    for (int32_t i = JOBS_MAX_TASKS - 1; i >= 0; --i) js->freeTasks[js->freeCount++] = i;
+    for (int i = 1; i < threadCount; ++i)
+        js->threads.emplace_back(WorkerMain, js, (uint32_t)i);
+    return js;
+}
+
+void Jobs_Destroy(JobSystem* js) {
+    if (!js) return;
+    {
+        std::lock_guard<std::mutex> lock(js->sleepMutex);
+        js->quit = true;
+    }
+    js->wake.notify_all();
+    for (std::thread& t : js->threads) t.join();
+    delete js;
+}
+
+int Jobs_WorkerCount(const JobSystem* js) {
+    return js ? js->workers : 1;
+}
+
+JobTask* Jobs_Submit(JobSystem* js, int32_t count, int32_t minRange, JobRangeFn fn, void* ctx) {
+    if (!js || js->threads.empty() || count <= 0) return nullptr;
+    if (minRange < 1) minRange = 1;
+
+    JobTask* task = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(js->taskMutex);
+        if (js->freeCount == 0) return nullptr;
+        task = &js->tasks[js->freeTasks[--js->freeCount]];
+    }
+
+    // A few ranges per worker so uneven items still balance, and never more than half a queue
+    int32_t chunk = std::max(minRange, count / (js->workers * 4));
+    chunk = std::max(chunk, (count + (int32_t)kQueueCapacity / 2 - 1) / ((int32_t)kQueueCapacity / 2));
+    const int32_t ranges = (count + chunk - 1) / chunk;
+
+    task->fn    = fn;
+    task->ctx   = ctx;
+    task->chunk = chunk;
+    task->deferredEnd = 0;
+    task->remaining.store(ranges, std::memory_order_relaxed);
+
+    const uint32_t worker = Self(js);
+    WorkQueue& q = js->queues[worker];
+    int32_t pushed = 0;
+    {
+        std::lock_guard<std::mutex> lock(q.mutex);
+        // Pushed last-range-first so the owner's pops (from the tail) go front to back
+        for (int32_t r = ranges - 1; r >= 0; --r) {
+            const int32_t b = r * chunk;
+            if (!PushBack(q, { task, b, std::min(b + chunk, count) })) {
+                task->deferredEnd = std::min(b + chunk, count);
+                break;
+            }
+            pushed++;
+        }
+    }
+    js->queued.fetch_add(pushed, std::memory_order_release);
+    { std::lock_guard<std::mutex> lock(js->sleepMutex); }
+    js->wake.notify_all();
+
+    // Whatever didn't fit waits for Jobs_Wait rather than running here: Box2D expects
+    // enqueueTask to return while the queued ranges are still in flight
+    return task;
+}
+
+void Jobs_Wait(JobSystem* js, JobTask* task) {
+    if (!js || !task) return;
+
+    const uint32_t worker = Self(js);
+    for (int32_t b = 0; b < task->deferredEnd; b += task->chunk)
+        RunItem(js, { task, b, std::min(b + task->chunk, task->deferredEnd) }, worker);
+
+    while (task->remaining.load(std::memory_order_acquire) > 0) {
+        if (TryRunOne(js, worker)) continue;
+
+        std::unique_lock<std::mutex> lock(js->sleepMutex);
+        js->wake.wait(lock, [&]{
+            return task->remaining.load(std::memory_order_acquire) == 0 ||
+                   js->queued.load(std::memory_order_acquire) > 0;
+        });
+    }
+
+    std::lock_guard<std::mutex> lock(js->taskMutex);
+    js->freeTasks[js->freeCount++] = (int32_t)(task - js->tasks);
+}
+
+void Jobs_ParallelFor(JobSystem* js, int32_t count, int32_t minRange, JobRangeFn fn, void* ctx) {
+    if (count <= 0) return;
+    if (minRange < 1) minRange = 1;
+
+    if (Jobs_WorkerCount(js) == 1 || count <= minRange) {
+        fn(0, count, Self(js), ctx);
+        return;
+    }
+
+    JobTask* task = Jobs_Submit(js, count, minRange, fn, ctx);
+    if (!task) {
+        fn(0, count, Self(js), ctx);
+        return;
+    }
+    Jobs_Wait(js, task);
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+
+// Small fixed-size work-stealing pool. The calling thread takes part as worker 0, so a pool
+// of N has N-1 background threads and N scratch slots. Each worker has its own queue of
+// ranges: it works newest-first on its own queue and steals oldest-first from the others
+// when it runs dry. Submit and wait from worker 0 (the thread that created the pool) or
+// from inside a job.
+
+typedef void (*JobRangeFn)(int32_t begin, int32_t end, uint32_t worker, void* ctx);
+
+struct JobSystem;
+struct JobTask;
+
+extern JobSystem* g_jobs;   // created in main(), may be null (everything runs inline)
+
+// Upper bound on tasks submitted and not yet waited on
+#define JOBS_MAX_TASKS 128
+
+// threadCount <= 0 picks the hardware concurrency. 1 means no background threads.
+JobSystem* Jobs_Create(int threadCount);
+void       Jobs_Destroy(JobSystem* js);
+
+// Number of distinct worker indices fn can see (1 for a null pool).
+int        Jobs_WorkerCount(const JobSystem* js);
+
+// Queues fn over [0, count) split into ranges of at least minRange items and returns at
+// once. Returns null if the work can't be queued (no background threads, or every task
+// slot is taken); the caller then runs fn itself. Ranges that don't fit in the calling
+// worker's queue are held back and run by Jobs_Wait.
+JobTask*   Jobs_Submit(JobSystem* js, int32_t count, int32_t minRange, JobRangeFn fn, void* ctx);
+// Runs the task's held-back ranges, then queued ranges (from any task) until task is done,
+// and frees it
+void       Jobs_Wait(JobSystem* js, JobTask* task);
+
+// Calls fn over [0, count) split into ranges of at least minRange items and blocks until
+// every range is done. Safe to call with a null pool.
+void       Jobs_ParallelFor(JobSystem* js, int32_t count, int32_t minRange, JobRangeFn fn, void* ctx);
@@ -18,11 +18,72 @@ static int rrange(uint32_t* s, int a, int b){ return a + (int)(xr(s)% (uint32_t)
 bool grid_init(Grid* g, int w, int h) {
     g->w = w; g->h = h;
     g->t = (Tile*)malloc((size_t)w*h*sizeof(Tile));
-    return g->t != NULL;
+    g->walkStride = (w + 63) / 64 + 2;
+    g->walk = (uint64_t*)calloc((size_t)g->walkStride * (h + 2*WALK_PAD_ROWS), sizeof(uint64_t));
+    return g->t != NULL && g->walk != NULL;
 }
 
 void grid_free(Grid* g) {
     free(g->t); g->t = NULL; g->w = g->h = 0;
+    free(g->walk); g->walk = NULL; g->walkStride = 0;
+}
+
+void grid_sync_walk(Grid* g, int x, int y, int w, int h) {
+    int x1 = x, y1 = y, x2 = x+w-1, y2 = y+h-1;
+    if (x1 < 0) x1 = 0;
+    if (y1 < 0) y1 = 0;
+    if (x2 >= g->w) x2 = g->w - 1;
+    if (y2 >= g->h) y2 = g->h - 1;
+    for (int yy=y1; yy<=y2; ++yy) {
+        uint64_t* row = g->walk + (size_t)(yy + WALK_PAD_ROWS) * g->walkStride;
+        for (int xx=x1; xx<=x2; ++xx) {
+            const uint64_t bit = 1ull << ((xx + 64) & 63);
+            if (g->t[grid_idx(g,xx,yy)].id == TILE_FLOOR) row[(xx + 64) >> 6] |= bit;
+            else row[(xx + 64) >> 6] &= ~bit;
+        }
+    }
+}
+
+bool grid_walk_box(const Grid* g, int x0, int y0, int x1, int y1) {
+    if (x0<0 || y0<0 || x1>=g->w || y1>=g->h) return false;
+    const int b0 = x0 + 64, b1 = x1 + 64;
+    const int w0 = b0 >> 6, w1 = b1 >> 6;
+    for (int y=y0; y<=y1; ++y) {
+        const uint64_t* row = grid_walk_row(g, y);
+        for (int j=w0; j<=w1; ++j) {
+            uint64_t mask = ~0ull;
+            if (j == w0) mask &= ~0ull << (b0 & 63);
+            if (j == w1) mask &= ~0ull >> (63 - (b1 & 63));
+            if ((row[j] & mask) != mask) return false;
+        }
+    }
+    return true;
+}
+
+// Vertical AND of word j over rows y-r..y+r (padding rows are zero)
+static inline uint64_t walk_column_and(const Grid* g, int y, int r, int j) {
+    uint64_t v = ~0ull;
+    for (int yy=y-r; yy<=y+r; ++yy) v &= grid_walk_row(g, yy)[j];
+    return v;
+}
+
+void grid_walk_clearance_row(const Grid* g, int y, int r, uint64_t* out) {
+    const int n = g->walkStride;
+    out[0] = out[n-1] = 0;
+
+    // Erode vertically, then horizontally by shifting neighbouring words in
+    uint64_t prev = 0, cur = walk_column_and(g, y, r, 1);
+    for (int j=1; j<n-1; ++j) {
+        const uint64_t next = (j+1 < n-1) ? walk_column_and(g, y, r, j+1) : 0;
+        uint64_t v = cur;
+        for (int k=1; k<=r; ++k) {
+            v &= (cur >> k) | (next << (64-k));   // tile x+k
+            v &= (cur << k) | (prev >> (64-k));   // tile x-k
+        }
+        out[j] = v;
+        prev = cur;
+        cur = next;
+    }
 }
 
 Tile* grid_at(Grid* g, int x, int y) {
@@ -32,6 +93,7 @@ Tile* grid_at(Grid* g, int x, int y) {
 
 void grid_fill(Grid* g, uint8_t id, uint8_t flags) {
     for (int i=0;i<g->w*g->h;i++){ g->t[i].id=id; g->t[i].flags=flags; }
+    grid_sync_walk(g, 0, 0, g->w, g->h);
 }
 
 void grid_set_rect(Grid* g, int x, int y, int w, int h, uint8_t id, uint8_t flags) {
@@ -43,6 +105,7 @@ void grid_set_rect(Grid* g, int x, int y, int w, int h, uint8_t id, uint8_t flag
         Tile* t=&g->t[grid_idx(g,xx,yy)];
         t->id=id; t->flags=flags;
     }
+    grid_sync_walk(g, x, y, w, h);
 }
 
 // --- carving helpers --------------------------------------------------
@@ -93,23 +156,23 @@ static void carve_corridor_wide(Grid* g, int cx0, int cy0, int cx1, int cy1, int
     }
 }
 
-// After carving floors, this to surrounds floors with walls (cheap “outline”)
-static void outline_walls(Grid* g) {
-    for (int y=1; y<g->h-1; ++y)
-    for (int x=1; x<g->w-1; ++x) {
-        Tile* t = grid_at(g,x,y);
-        if (t->id == TILE_FLOOR) continue;
-        bool neighborFloor =
-            (grid_at(g,x+1,y)->id==TILE_FLOOR) ||
-            (grid_at(g,x-1,y)->id==TILE_FLOOR) ||
-            (grid_at(g,x,y+1)->id==TILE_FLOOR) ||
-            (grid_at(g,x,y-1)->id==TILE_FLOOR);
-        if (neighborFloor) set_tile(t, TILE_WALL);
-        else set_tile(t, TILE_WALL); // keep solid outside too
-    }
+// Level Generation
+LevelGenParams level_gen_params(int w, int h, uint32_t seed) {
+    LevelGenParams params = {
+        .attempts = 18,
+        .roomMinW = 6, .roomMinH = 6,
+        .roomMaxW = 12, .roomMaxH = 10,
+        .corridorMinW = 2,
+        .corridorMaxW = 4,
+        .seed = seed
+    };
+
+    // Keep room density roughly constant on larger maps
+    params.attempts = params.attempts * (w * h) / (80 * 45);
+    if (params.attempts < 18) params.attempts = 18;
+    return params;
 }
 
-// Level Generation
 void gen_level(Grid* g, const LevelGenParams* p) {
     uint32_t seed = p->seed ? p->seed : (uint32_t)time(NULL);
     uint32_t rng = seed;
@@ -123,7 +186,7 @@ void gen_level(Grid* g, const LevelGenParams* p) {
         int rw = rrange(&rng, p->roomMinW, p->roomMaxW);
         int rh = rrange(&rng, p->roomMinH, p->roomMaxH);
 
-        // keep a 1-tile border so outline doesn't go OOB
+        // keep a 1-tile wall border around the map
         int rxMin = 1, ryMin = 1;
         int rxMax = g->w - rw - 2;
         int ryMax = g->h - rh - 2;
@@ -150,13 +213,13 @@ void gen_level(Grid* g, const LevelGenParams* p) {
         prev_cx = cx; prev_cy = cy;
     }
 
-    outline_walls(g);
+    // Carving only ever writes floor, so every other tile is still wall from the fill above
+    grid_sync_walk(g, 0, 0, g->w, g->h);
 }
 
 // Axis-separated sweep against blocking tiles
 static bool tile_blocks(const Grid* g, int tx, int ty) {
-    if (tx<0 || ty<0 || tx>=g->w || ty>=g->h) return true; // outside = solid
-    return g->t[grid_idx(g,tx,ty)].id == TILE_WALL;
+    return !grid_walkable(g, tx, ty); // outside = solid
 }
 
 void collide_aabb_vs_walls(const Grid* g, float* px, float* py, float halfw, float halfh, float vx, float vy) {
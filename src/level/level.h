@@ -1,6 +1,10 @@
 #pragma once
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 #define TILE_SIZE 32   // pixels per tile
 
@@ -19,9 +23,18 @@ typedef struct {
     uint8_t flags;  // TF_*
 } Tile;
 
+// Walkability bitmap padding: one blank word left and right of every row and this many
+// blank rows above and below, so neighbourhood reads within the padding need no bounds checks
+#define WALK_PAD_ROWS 4
+
 typedef struct {
     int w, h;   // in tiles
     Tile* t;    // length = w*h (row-major)
+
+    // Derived from t: bit set = TILE_FLOOR. Tile (x,y) is bit (x+64)&63 of word
+    // (y+WALK_PAD_ROWS)*walkStride + (x+64)/64. Rebuilt by grid_sync_walk.
+    uint64_t* walk;
+    int walkStride;     // words per row, padding included
 } Grid;
 
 typedef struct {
@@ -40,8 +53,24 @@ Tile* grid_at(Grid* g, int x, int y);
 void  grid_fill(Grid* g, uint8_t id, uint8_t flags);
 void  grid_set_rect(Grid* g, int x, int y, int w, int h, uint8_t id, uint8_t flags);
 
+// Refreshes the walkability bits for a rect of tiles. The grid_* writers and gen_level
+// call it; anything writing g->t directly must call it afterwards.
+void  grid_sync_walk(Grid* g, int x, int y, int w, int h);
+
+// True if every tile in the inclusive box is floor; out-of-bounds counts as blocked.
+// Word operations per row.
+bool  grid_walk_box(const Grid* g, int x0, int y0, int x1, int y1);
+
+// Bits of row y (same layout as a walk row, walkStride words) for tiles whose
+// (2r+1)x(2r+1) neighbourhood is all floor. r <= WALK_PAD_ROWS.
+void  grid_walk_clearance_row(const Grid* g, int y, int r, uint64_t* out);
+
 void gen_level(Grid* g, const LevelGenParams* p);
 
+// The game's room/corridor settings for a w x h map, room attempts scaled with the area so
+// larger maps keep the same density
+LevelGenParams level_gen_params(int w, int h, uint32_t seed);
+
 // Collision against WALL tiles. Mutates pos to resolve.
 void  collide_aabb_vs_walls(const Grid* g, float* px, float* py, float halfw, float halfh, float vx, float vy);
 
@@ -49,3 +78,28 @@ void  collide_aabb_vs_walls(const Grid* g, float* px, float* py, float halfw, fl
 static inline int grid_idx(const Grid* g, int x, int y) { return y*g->w + x; }
 static inline bool in_bounds(const Grid* g, int x, int y) { return x>=0 && y>=0 && x<g->w && y<g->h; }
 
+static inline const uint64_t* grid_walk_row(const Grid* g, int y) {
+    return g->walk + (size_t)(y + WALK_PAD_ROWS) * g->walkStride;
+}
+
+// Unchecked: valid for -64 <= x < w+64 and -WALK_PAD_ROWS <= y < h+WALK_PAD_ROWS
+static inline bool grid_walk_bit(const Grid* g, int x, int y) {
+    return (grid_walk_row(g, y)[(x + 64) >> 6] >> ((x + 64) & 63)) & 1u;
+}
+
+static inline bool grid_walkable(const Grid* g, int x, int y) {
+    return in_bounds(g, x, y) && grid_walk_bit(g, x, y);
+}
+
+// Index of the lowest set bit of a non-zero word
+static inline int walk_ctz(uint64_t v) {
+#if defined(_MSC_VER)
+    unsigned long i; _BitScanForward64(&i, v); return (int)i;
+#else
+    return __builtin_ctzll(v);
+#endif
+}
+
+// Tile x of bit b in walk word j
+static inline int walk_bit_x(int j, int b) { return (j << 6) + b - 64; }
+
@@ -5,9 +5,16 @@
 #include "player/projectile.h"
 #include "physics/physics.h"
 #include "entity/enemies.hpp"
-#include "../lib/box2d/include/box2d/box2d.h"
+#include "game/game.h"
+#include "jobs/jobs.h"
+#include "render/tilemap_cache.h"
+#include "render/visibility.h"
+#include "anims/atlas.hpp"
+#include "anims/sprites.hpp"
 #include "state.h"
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 void DrawScoreboard() {
     const int fontSize = 28;
@@ -26,170 +33,120 @@ void DrawScoreboard() {
     DrawText(text2, x2, margin + 30, fontSize, RAYWHITE);
 }
 
-void RestartGame(Player* player, EntitySystem* es, Grid* level, b2WorldId* world) {
-    Enemies_Clear();
-
-    g_enemiesKilled = 0;
-    g_wave = 0;
-    g_speedMultiplier = 1.0f;
-    g_lastWaveSpawned = 0;
-
-    if (b2World_IsValid(*world)) {
-        b2DestroyWorld(*world);
-    }
-
-    *world = InitWorld();
-    BuildStaticsFromGrid(*world, level);
-
-    // New ID-based maps
-    g_entityToBody.clear();
-    g_bodyToEntity.clear();
-    es->pool.clear();
-
-    Player_Init(player, level);
-    g_playerBody = CreatePlayer(*world, player->pos, 12.0f, 12.0f, 6.0f);
-
-    // Props / boxes
-    Entities_SpawnBoxesInLevel(es, level, 10, 20, (Vector2){10.f, 10.f}, 0);
-    Create_Entity_Bodies(es, *world);
-
-    // Enemies
-    const size_t prevCount = es->pool.size();
-    Enemies_Spawn(es, level, player->pos, 6, 150.0f);
-    Enemies_CreateBodies(es, *world, prevCount);
-
-    TraceLog(LOG_INFO, "Restart: entities=%zu enemies=%zu maps: e2b=%zu b2e=%zu",
-             es->pool.size(), g_enemies.size(),
-             g_entityToBody.size(), g_bodyToEntity.size());
-
-    g_projectiles.clear();
-
-    player->cam.target = player->pos;
-
-    g_gameOver = false;
+// F1 overlay: tile draw calls and frame time, to compare baked and immediate tiles (F2),
+// and how many objects the visibility pass submitted vs culled
+static void DrawRenderStats(const TilemapStats* stats, bool baked, const Grid* g, const VisStats* vis) {
+    char line[160];
+    snprintf(line, sizeof(line), "%dx%d  tiles: %s  draws=%u chunks=%u bakes=%u resident=%u  %.2f ms",
+             g->w, g->h, baked ? "baked" : "immediate", stats->drawCalls, stats->chunksDrawn,
+             stats->bakes, stats->resident, GetFrameTime() * 1000.0f);
+    DrawText(line, 20, GetScreenHeight() - 30, 20, YELLOW);
+
+    int len = 0;
+    for (int k = 0; k < VIS_COUNT; ++k)
+        len += snprintf(line + len, sizeof(line) - len, "%s %u/%u  ", VisKind_Name(k),
+                        vis->submitted[k], vis->submitted[k] + vis->culled[k]);
+    DrawText(line, 20, GetScreenHeight() - 55, 20, YELLOW);
 }
 
-int main() {
-    InitWindow(1280, 720, "SpellForge");
-    SetTargetFPS(60);
-    
-    Grid g;
-    grid_init(&g, 80, 45);
-
-    LevelGenParams params = {
-        .attempts = 18,
-        .roomMinW = 6, .roomMinH = 6,
-        .roomMaxW = 12, .roomMaxH = 10,
-        .corridorMinW = 2,
-        .corridorMaxW = 4,
-        .seed = 0
-    };
+// Keyboard/mouse state for this frame, in the simulation's terms
+static SimInput ReadInput(const Player* player) {
+    SimInput in = {};
+    in.move     = Build_Input();
+    in.aimWorld = GetScreenToWorld2D(GetMousePosition(), player->cam);
+    in.fire     = IsMouseButtonDown(MOUSE_BUTTON_LEFT);
 
-    gen_level(&g, &params);
+    in.holdTelekinesis    = IsKeyDown(KEY_SPACE);
+    in.releaseTelekinesis = IsKeyReleased(KEY_SPACE);
 
-    EntitySystem ents;
-    Entities_Init(&ents, 0);
+    in.selectProjectile = -1;
+    if (IsKeyPressed(KEY_Q)) in.selectProjectile = (int8_t)ProjectileType::FIRE;
+    if (IsKeyPressed(KEY_E)) in.selectProjectile = (int8_t)ProjectileType::ICE;
 
-    // Spawn some props/boxes in the level
-    Entities_SpawnBoxesInLevel(&ents, &g, 10, 20, (Vector2){10.f, 10.f}, 0);
+    in.cyclePathMode = IsKeyPressed(KEY_P);
+    return in;
+}
 
-    // INIT PHYSICS
-    b2WorldId world = InitWorld();
-    BuildStaticsFromGrid(world, &g);
+int main(int argc, char** argv) {
+    GameConfig config;
+    int threads = 0;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (!strcmp(argv[i], "--size"))
+            sscanf(argv[++i], "%dx%d", &config.levelW, &config.levelH);
+        else if (!strcmp(argv[i], "--threads"))
+            threads = atoi(argv[++i]);
+    }
 
-    Player player;
-    Player_Init(&player, &g);
+    InitWindow(1280, 720, "SpellForge");
+    // Render at the display rate; the simulation ticks at its own fixed rate
+    SetTargetFPS(GetMonitorRefreshRate(GetCurrentMonitor()));
+    g_jobs = Jobs_Create(threads);   // before Game_Init: the physics world steps on it
 
-    Vector2 spawnpx = player.pos;
-    b2BodyId playerBody = CreatePlayer(world, spawnpx, 12.0f, 12.0f); // linear damping default
+    // Sprites and shapes share one texture so the scene draws in a few batches
+    Atlas_Build(kSpriteSheets, (int32_t)(sizeof(kSpriteSheets) / sizeof(kSpriteSheets[0])));
 
-    // Create bodies for existing entities (props, etc.)
-    Create_Entity_Bodies(&ents, world);
+    Game game;
+    Game_Init(&game, &config);
 
-    // Enemies
-    const size_t prevCount = ents.pool.size();
-    Enemies_Spawn(&ents, &g, player.pos, 10, 300.0f);
-    Enemies_CreateBodies(&ents, world, prevCount);
+    Grid& g = game.grid;
+    Player& player = game.player;
 
+    TilemapCache tiles;
+    TilemapCache_Init(&tiles, &g, 48);
+    VisibleSet visible;
+    bool bakedTiles = true;
+    bool showStats  = false;
 
-    TraceLog(LOG_INFO, "WORLD BUILT SETUP COMPLETE: entities=%zu enemies=%zu maps: e2b=%zu b2e=%zu",
-             ents.pool.size(), g_enemies.size(),
-             g_entityToBody.size(), g_bodyToEntity.size());
+    FixedStep step;
+    SimInput pending = {};
+    pending.selectProjectile = -1;
 
     while (!WindowShouldClose()) {
-        float dt = GetFrameTime();
-
-        Vector2 dir = Build_Input();
-        UpdatePlayer(&player, playerBody, tick, dir, 125.0f);
-
-        if (IsKeyDown(KEY_SPACE)) {
-            Telekinesis_Hold(player.pos, 50.0f, teleForce, &ents);
-        } else if (IsKeyReleased(KEY_SPACE)) {
-            Telekinesis_Fire(player.pos, 50.0f, 500.0f, &ents);
-        }
-
-        Projectile_HandleSwitch();
-        Projectile_Shoot(world, player.pos, player.cam);
-
-        Enemies_Update(&ents, &g, playerBody, tick);
-
-        b2World_Step(world, tick, subSteps);
-
-        Contact_ProcessPlayerEnemy(world, &ents);
-        Projectile_Update(world, &ents, tick);
-        Entities_Update(&ents, tick);
-
-        // Sync player camera
-        Vector2 playerPosPx = GetPlayerPixels(playerBody);
-        player.pos = playerPosPx;
-        player.cam.target = playerPosPx;
-
-        // Spawn waves
-        if (g_enemiesKilled / 2 > g_lastWaveSpawned) {
-            g_wave++;
-            g_lastWaveSpawned = g_enemiesKilled / 2;
-
-            g_speedMultiplier += 0.05f;
-            int spawnCount = 4;
-
-            TraceLog(LOG_INFO, "Wave %d triggered! Kills=%d Speed x%.2f",
-                     g_wave, g_enemiesKilled, g_speedMultiplier);
-
-            const size_t prevCountWave = ents.pool.size();
-            Enemies_Spawn(&ents, &g, playerPosPx, spawnCount, 700.0f);
-            Enemies_CreateBodies(&ents, world, prevCountWave);
-
-            TraceLog(LOG_INFO, "Wave spawn: entities=%zu enemies=%zu maps: e2b=%zu b2e=%zu",
-                     ents.pool.size(), g_enemies.size(),
-                     g_entityToBody.size(), g_bodyToEntity.size());
+        // Held state comes from this frame; one-shot presses are latched until a tick runs,
+        // since at high frame rates most frames run no tick at all.
+        SimInput input = ReadInput(&player);
+        input.releaseTelekinesis |= pending.releaseTelekinesis;
+        input.cyclePathMode      |= pending.cyclePathMode;
+        if (input.selectProjectile < 0) input.selectProjectile = pending.selectProjectile;
+
+        const int ticks = FixedStep_Advance(&step, GetFrameTime() * timeScale, tick);
+        for (int i = 0; i < ticks; ++i) {
+            Game_Step(&game, &input, tick);
+            input.releaseTelekinesis = false;
+            input.selectProjectile   = -1;
+            input.cyclePathMode      = false;
         }
+        pending = input;
+        const float alpha = FixedStep_Alpha(&step, tick);
 
-        // Ensure deletions get flushed AFTER creations
-        Physics_FlushDeletions(world, &ents);
+        if (IsKeyPressed(KEY_F1)) showStats  = !showStats;
+        if (IsKeyPressed(KEY_F2)) bakedTiles = !bakedTiles;
 
         BeginDrawing();
         ClearBackground((Color){30,30,40,255});
 
+        player.cam.target = Player_RenderPos(&player, alpha);
+        const int screenW = GetScreenWidth(), screenH = GetScreenHeight();
+        if (bakedTiles) TilemapCache_Update(&tiles, player.cam, screenW, screenH);
+        Visibility_Gather(&visible, &game.ents, player.cam, screenW, screenH, 2.0f * TILE_SIZE, showStats);
+
         BeginMode2D(player.cam);
 
-        // Draw grid
-        for (int y = 0; y < g.h; ++y)
-            for (int x = 0; x < g.w; ++x) {
-                Tile* t = grid_at(&g, x, y);
-                Color c = (t->id == TILE_WALL) ? (Color){60,60,70,255} : (Color){200,200,200,255};
-                DrawRectangle(x * TILE_SIZE, y * TILE_SIZE, TILE_SIZE, TILE_SIZE, c);
-            }
+        // Static tiles
+        if (bakedTiles) TilemapCache_Draw(&tiles, player.cam, screenW, screenH);
+        else Tilemap_DrawImmediate(&g, &tiles.stats);
 
-        Entities_Draw(&ents);
-        Enemies_Draw(&ents);
-        Projectile_Draw();
-        Player_Draw(&player);
+        Entities_Draw(&game.ents, visible.props.data(), (int32_t)visible.props.size(), alpha);
+        Enemies_Draw(&game.ents, visible.enemies.data(), (int32_t)visible.enemies.size(), alpha);
+        Projectile_Draw(visible.projectiles.data(), (int32_t)visible.projectiles.size(), alpha);
+        Player_Draw(&player, alpha);
 
         EndMode2D();
 
         if (!g_gameOver) {
             DrawScoreboard();
         }
+        if (showStats) DrawRenderStats(&tiles.stats, bakedTiles, &g, &visible.stats);
 
         if (g_gameOver) {
             DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), BLACK);
@@ -225,16 +182,16 @@ int main() {
             DrawText(msg2, x2, y2, fontSize2, GRAY);
 
             if (IsKeyPressed(KEY_R)) {
-                RestartGame(&player, &ents, &g, &world);
-                g_gameOver = false;
+                Game_Restart(&game);
             }
         }
         EndDrawing();
     }
 
-    grid_free(&g);
-    Player_Unload(&player);
-    Enemies_Clear();
-    Entities_Clear(&ents);
+    TilemapCache_Free(&tiles);
+    Game_Shutdown(&game);
+    Atlas_Unload();
+    Jobs_Destroy(g_jobs);
+    g_jobs = nullptr;
     CloseWindow();
 }
@@ -0,0 +1,81 @@
+#include "arena.h"
+#include <cstdlib>
+
+Arena g_frameArena;
+Arena g_levelArena;
+
+// Heap block taken when the arena's own block is full
+struct ArenaOverflow {
+    ArenaOverflow* next;
+};
+
+static size_t AlignUp(size_t v, size_t align) {
+    return (v + align - 1) & ~(align - 1);
+}
+
+void Arena_Init(Arena* a, const char* name, size_t capacity) {
+    Arena_Free(a);
+    a->name = name;
+    a->base = capacity ? (uint8_t*)malloc(capacity) : nullptr;
+    a->capacity = a->base ? capacity : 0;
+}
+
+static void FreeOverflow(Arena* a) {
+    while (a->overflow) {
+        ArenaOverflow* next = a->overflow->next;
+        free(a->overflow);
+        a->overflow = next;
+    }
+    a->overflowBytes = 0;
+}
+
+void Arena_Free(Arena* a) {
+    FreeOverflow(a);
+    free(a->base);
+    a->base = nullptr;
+    a->capacity = a->used = 0;
+}
+
+void* Arena_Alloc(Arena* a, size_t bytes, size_t align) {
+    if (bytes == 0) bytes = 1;
+
+    // malloc'd blocks are max_align_t aligned, so aligning the offset aligns the address
+    const size_t start = AlignUp(a->used, align);
+    if (a->base && start + bytes <= a->capacity) {
+        a->used = start + bytes;
+        return a->base + start;
+    }
+
+    // Out of room: serve this one from the heap and remember to grow on reset
+    if (align > alignof(std::max_align_t)) return nullptr;
+    const size_t header = AlignUp(sizeof(ArenaOverflow), alignof(std::max_align_t));
+    ArenaOverflow* block = (ArenaOverflow*)malloc(header + bytes);
+    if (!block) return nullptr;
+    block->next = a->overflow;
+    a->overflow = block;
+    a->overflowBytes += AlignUp(bytes, alignof(std::max_align_t));
+    a->stats.overflows++;
+    return (uint8_t*)block + header;
+}
+
+void Arena_Reset(Arena* a) {
+    const size_t demand = a->used + a->overflowBytes;
+    if (demand > a->stats.peakBytes) a->stats.peakBytes = demand;
+    a->stats.resets++;
+
+    if (a->overflow) {
+        FreeOverflow(a);
+
+        // Regrow to the high-water mark plus headroom so the next lifetime fits
+        size_t cap = a->capacity ? a->capacity : 4096;
+        while (cap < a->stats.peakBytes + a->stats.peakBytes / 4) cap *= 2;
+        uint8_t* grown = (uint8_t*)malloc(cap);
+        if (grown) {
+            free(a->base);
+            a->base = grown;
+            a->capacity = cap;
+            a->stats.regrows++;
+        }
+    }
+    a->used = 0;
+}
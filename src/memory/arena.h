@@ -0,0 +1,74 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+// Linear (bump) allocator for data that dies all at once. Allocation is a pointer bump,
+// individual frees are no-ops, and Arena_Reset drops everything in one go.
+//
+// If the block runs out, the arena falls back to the heap for the overflow and, on the next
+// reset, regrows its block to the high-water mark. After a warm-up frame or level the arena
+// never touches the heap again.
+
+struct ArenaOverflow;
+
+struct ArenaStats {
+    uint64_t resets;
+    uint64_t overflows;      // allocations that missed the block and went to the heap
+    uint64_t regrows;        // block reallocations on reset
+    size_t   peakBytes;      // largest demand seen in one lifetime (block + overflow)
+};
+
+struct Arena {
+    uint8_t*       base     = nullptr;
+    size_t         capacity = 0;
+    size_t         used     = 0;
+    size_t         overflowBytes = 0;
+    ArenaOverflow* overflow = nullptr;
+    const char*    name     = "";
+    ArenaStats     stats    = {};
+};
+
+extern Arena g_frameArena;   // reset at the end of every Game_Step
+extern Arena g_levelArena;   // reset when a level is (re)built
+
+void   Arena_Init(Arena* a, const char* name, size_t capacity);
+void   Arena_Free(Arena* a);
+void*  Arena_Alloc(Arena* a, size_t bytes, size_t align = alignof(std::max_align_t));
+void   Arena_Reset(Arena* a);
+
+// Scoped scratch: everything allocated after the mark is released by Arena_Rewind.
+// Heap overflow taken meanwhile stays alive until the next reset.
+inline size_t Arena_Mark(const Arena* a)          { return a->used; }
+inline void   Arena_Rewind(Arena* a, size_t mark) { if (mark <= a->used) a->used = mark; }
+
+template <typename T>
+inline T* Arena_AllocArray(Arena* a, size_t count) {
+    return (T*)Arena_Alloc(a, sizeof(T) * count, alignof(T));
+}
+
+// STL adapter. deallocate() is a no-op, so reserve() up front where the size is known:
+// every regrowth leaves the old buffer behind until the arena resets.
+template <typename T>
+struct ArenaAllocator {
+    typedef T value_type;
+
+    Arena* arena;
+
+    explicit ArenaAllocator(Arena* a) : arena(a) {}
+    template <typename U> ArenaAllocator(const ArenaAllocator<U>& o) : arena(o.arena) {}
+
+    T* allocate(size_t n) {
+        void* p = Arena_Alloc(arena, sizeof(T) * n, alignof(T));
+        if (!p) throw std::bad_alloc();
+        return (T*)p;
+    }
+    void deallocate(T*, size_t) {}
+
+    template <typename U> bool operator==(const ArenaAllocator<U>& o) const { return arena == o.arena; }
+    template <typename U> bool operator!=(const ArenaAllocator<U>& o) const { return arena != o.arena; }
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
@@ -0,0 +1,332 @@
+#include "hpa.h"
+#include "path_common.h"
+#include <algorithm>
+#include <cstdlib>
+
+static const int kMaxSingleEntrance = 6;               // longer openings get an entrance at each end
+static const int kRefineTiles       = HPA_CLUSTER_SIZE; // refine hops until the path is at least this long
+
+struct BuildEdge { int32_t from, to, cost; };
+
+static inline int cluster_of(const HpaGraph* hg, int x, int y) {
+    return (y / HPA_CLUSTER_SIZE) * hg->clustersX + (x / HPA_CLUSTER_SIZE);
+}
+
+// Tile rect [x0,x1) x [y0,y1) covered by the cluster containing (x,y)
+static void cluster_rect(const Grid* g, int x, int y, int* x0, int* y0, int* x1, int* y1) {
+    *x0 = (x / HPA_CLUSTER_SIZE) * HPA_CLUSTER_SIZE;
+    *y0 = (y / HPA_CLUSTER_SIZE) * HPA_CLUSTER_SIZE;
+    *x1 = std::min(*x0 + HPA_CLUSTER_SIZE, g->w);
+    *y1 = std::min(*y0 + HPA_CLUSTER_SIZE, g->h);
+}
+
+static void HpaQuery_Reserve(HpaQuery* q) {
+    const int C = HPA_CLUSTER_SIZE;
+    if ((int)q->bfsStamp.size() == C * C) return;
+    q->bfsGeneration = 0;
+    q->bfsStamp.assign(C * C, 0);
+    q->bfsDist.assign(C * C, 0);
+    q->bfsQueue.assign(C * C, 0);
+}
+
+// BFS from (sx,sy) that never leaves its cluster. Distances land in bfsDist (cluster-local
+// index), valid where bfsStamp matches bfsGeneration. The origin may be a wall tile.
+static void cluster_bfs(HpaQuery* query, const Grid* g, int sx, int sy) {
+    const int C = HPA_CLUSTER_SIZE;
+    int x0, y0, x1, y1;
+    cluster_rect(g, sx, sy, &x0, &y0, &x1, &y1);
+
+    if (++query->bfsGeneration == 0) {
+        std::fill(query->bfsStamp.begin(), query->bfsStamp.end(), 0);
+        query->bfsGeneration = 1;
+    }
+    const uint32_t gen = query->bfsGeneration;
+    uint32_t* stamp = query->bfsStamp.data();
+    int32_t*  dist  = query->bfsDist.data();
+    int32_t*  q     = query->bfsQueue.data();
+    int head = 0, tail = 0;
+
+    int s = (sy - y0) * C + (sx - x0);
+    stamp[s] = gen;
+    dist[s]  = 0;
+    q[tail++] = s;
+
+    while (head < tail) {
+        int cur = q[head++];
+        int cx = x0 + cur % C;
+        int cy = y0 + cur / C;
+        for (auto& d : kDirs) {
+            int nx = cx + d[0];
+            int ny = cy + d[1];
+            if (nx < x0 || ny < y0 || nx >= x1 || ny >= y1) continue;
+            if (!is_floor(g, nx, ny)) continue;
+
+            int li = (ny - y0) * C + (nx - x0);
+            if (stamp[li] == gen) continue;
+            stamp[li] = gen;
+            dist[li]  = dist[cur] + 1;
+            q[tail++] = li;
+        }
+    }
+}
+
+// Distance from the last cluster_bfs origin to (x,y) in the same cluster, -1 if unreached
+static int32_t cluster_dist(const HpaQuery* query, int x, int y) {
+    const int C = HPA_CLUSTER_SIZE;
+    int li = (y % C) * C + (x % C);
+    return (query->bfsStamp[li] == query->bfsGeneration) ? query->bfsDist[li] : -1;
+}
+
+// Connects a query endpoint to every entrance of its cluster it can reach inside the cluster
+static void connect_endpoint(const HpaGraph* hg, HpaQuery* q, const Grid* g, int x, int y,
+                             std::vector<HpaEdge>& out) {
+    out.clear();
+    cluster_bfs(q, g, x, y);
+
+    int c = cluster_of(hg, x, y);
+    for (int i = hg->clusterStart[c]; i < hg->clusterStart[c + 1]; ++i) {
+        int n = hg->clusterNodes[i];
+        int t = hg->nodeTile[n];
+        int32_t d = cluster_dist(q, t % g->w, t / g->w);
+        if (d >= 0) out.push_back({ n, d });
+    }
+}
+
+void Hpa_Build(HpaGraph* hg, const Grid* g) {
+    const int C = HPA_CLUSTER_SIZE;
+    const int W = g->w, H = g->h;
+
+    hg->w = W;
+    hg->h = H;
+    hg->clustersX = (W + C - 1) / C;
+    hg->clustersY = (H + C - 1) / C;
+    const int clusterCount = hg->clustersX * hg->clustersY;
+
+    hg->nodeTile.clear();
+    hg->nodeCluster.clear();
+
+    HpaQuery bfs;
+    HpaQuery_Reserve(&bfs);
+
+    std::vector<int32_t> nodeAt((size_t)W * H, -1);
+    std::vector<BuildEdge> build;
+
+    auto node_for = [&](int x, int y) {
+        int t = grid_idx(g, x, y);
+        if (nodeAt[t] < 0) {
+            nodeAt[t] = (int32_t)hg->nodeTile.size();
+            hg->nodeTile.push_back(t);
+            hg->nodeCluster.push_back(cluster_of(hg, x, y));
+        }
+        return nodeAt[t];
+    };
+    auto add_entrance = [&](int ax, int ay, int bx, int by) {
+        int a = node_for(ax, ay);
+        int b = node_for(bx, by);
+        build.push_back({ a, b, 1 });
+        build.push_back({ b, a, 1 });
+    };
+    // An opening is a run of tiles [r0,r1] walkable on both sides of a border.
+    // (ox,oy) maps a run coordinate to the tile on the near side; (dx,dy) steps across.
+    auto add_opening = [&](int r0, int r1, bool vertical, int fixed) {
+        auto near_xy = [&](int r, int* x, int* y) { if (vertical) { *x = fixed; *y = r; } else { *x = r; *y = fixed; } };
+        int dx = vertical ? 1 : 0, dy = vertical ? 0 : 1;
+        int ax, ay;
+        if (r1 - r0 + 1 <= kMaxSingleEntrance) {
+            near_xy((r0 + r1) / 2, &ax, &ay);
+            add_entrance(ax, ay, ax + dx, ay + dy);
+        } else {
+            near_xy(r0, &ax, &ay);
+            add_entrance(ax, ay, ax + dx, ay + dy);
+            near_xy(r1, &ax, &ay);
+            add_entrance(ax, ay, ax + dx, ay + dy);
+        }
+    };
+
+    // Vertical borders: cluster column cx | cx+1
+    for (int cx = 0; cx + 1 < hg->clustersX; ++cx) {
+        int x0 = (cx + 1) * C - 1;
+        for (int cy = 0; cy < hg->clustersY; ++cy) {
+            int yEnd = std::min((cy + 1) * C, H);
+            int runStart = -1;
+            for (int y = cy * C; y <= yEnd; ++y) {
+                bool open = y < yEnd && is_floor(g, x0, y) && is_floor(g, x0 + 1, y);
+                if (open && runStart < 0) runStart = y;
+                if (!open && runStart >= 0) { add_opening(runStart, y - 1, true, x0); runStart = -1; }
+            }
+        }
+    }
+
+    // Horizontal borders: cluster row cy / cy+1
+    for (int cy = 0; cy + 1 < hg->clustersY; ++cy) {
+        int y0 = (cy + 1) * C - 1;
+        for (int cx = 0; cx < hg->clustersX; ++cx) {
+            int xEnd = std::min((cx + 1) * C, W);
+            int runStart = -1;
+            for (int x = cx * C; x <= xEnd; ++x) {
+                bool open = x < xEnd && is_floor(g, x, y0) && is_floor(g, x, y0 + 1);
+                if (open && runStart < 0) runStart = x;
+                if (!open && runStart >= 0) { add_opening(runStart, x - 1, false, y0); runStart = -1; }
+            }
+        }
+    }
+
+    const int N = (int)hg->nodeTile.size();
+
+    // Bucket nodes by cluster
+    hg->clusterStart.assign(clusterCount + 1, 0);
+    for (int n = 0; n < N; ++n) hg->clusterStart[hg->nodeCluster[n] + 1]++;
+    for (int c = 0; c < clusterCount; ++c) hg->clusterStart[c + 1] += hg->clusterStart[c];
+    hg->clusterNodes.assign(N, 0);
+    {
+        std::vector<int32_t> fill(hg->clusterStart.begin(), hg->clusterStart.end() - 1);
+        for (int n = 0; n < N; ++n) hg->clusterNodes[fill[hg->nodeCluster[n]]++] = n;
+    }
+
+    // Intra-cluster edges: one cluster-bounded BFS per entrance
+    for (int c = 0; c < clusterCount; ++c) {
+        for (int i = hg->clusterStart[c]; i < hg->clusterStart[c + 1]; ++i) {
+            int a = hg->clusterNodes[i];
+            cluster_bfs(&bfs, g, hg->nodeTile[a] % W, hg->nodeTile[a] / W);
+
+            for (int j = hg->clusterStart[c]; j < hg->clusterStart[c + 1]; ++j) {
+                int b = hg->clusterNodes[j];
+                if (a == b) continue;
+                int32_t d = cluster_dist(&bfs, hg->nodeTile[b] % W, hg->nodeTile[b] / W);
+                if (d > 0) build.push_back({ a, b, d });
+            }
+        }
+    }
+
+    // Pack into CSR
+    hg->edgeStart.assign(N + 1, 0);
+    for (const BuildEdge& e : build) hg->edgeStart[e.from + 1]++;
+    for (int n = 0; n < N; ++n) hg->edgeStart[n + 1] += hg->edgeStart[n];
+    hg->edges.assign(build.size(), HpaEdge{});
+    {
+        std::vector<int32_t> fill(hg->edgeStart.begin(), hg->edgeStart.end() - 1);
+        for (const BuildEdge& e : build) hg->edges[fill[e.from]++] = { e.to, e.cost };
+    }
+}
+
+bool Hpa_FindPath(const HpaGraph* hg, HpaQuery* q, PathContext* ctx, const Grid* g,
+                  Vector2 startPx, Vector2 goalPx, std::vector<Vector2>& outPath) {
+    outPath.clear();
+    q->lastAbstractExpanded = 0;
+    q->lastRefineExpanded   = 0;
+
+    int sx = (int)(startPx.x / TILE_SIZE);
+    int sy = (int)(startPx.y / TILE_SIZE);
+    int gx = (int)(goalPx.x / TILE_SIZE);
+    int gy = (int)(goalPx.y / TILE_SIZE);
+
+    if (!in_bounds(g, sx, sy) || !is_floor(g, gx, gy)) return false;
+    if (sx == gx && sy == gy) return true;
+
+    const int sc = cluster_of(hg, sx, sy);
+    const int gc = cluster_of(hg, gx, gy);
+
+    // Short queries: plain A* is already cheap and exact
+    if (sc == gc || abs(sx - gx) + abs(sy - gy) <= HPA_CLUSTER_SIZE) {
+        bool ok = AStar_AppendPathInRect(ctx, g, sx, sy, gx, gy, 0, 0, g->w, g->h, outPath);
+        q->lastRefineExpanded = ctx->lastExpanded;
+        return ok;
+    }
+
+    // Insert start and goal; every crossing out of a cluster passes an entrance, so if
+    // either side reaches none of them the goal is unreachable
+    HpaQuery_Reserve(q);
+    connect_endpoint(hg, q, g, sx, sy, q->startEdges);
+    connect_endpoint(hg, q, g, gx, gy, q->goalEdges);
+    if (q->startEdges.empty() || q->goalEdges.empty()) return false;
+
+    // Scratch covers N entrances + inserted start + inserted goal
+    const int N = (int)hg->nodeTile.size();
+    if ((int)q->stamp.size() != N + 2) {
+        q->generation = 0;
+        q->stamp.assign(N + 2, 0);
+        q->gCost.assign(N + 2, 0);
+        q->parent.assign(N + 2, -1);
+        q->open.reserve(N + 2);
+    }
+    const int S = N, G = N + 1;
+    auto node_x = [&](int n) { return n == S ? sx : n == G ? gx : hg->nodeTile[n] % g->w; };
+    auto node_y = [&](int n) { return n == S ? sy : n == G ? gy : hg->nodeTile[n] / g->w; };
+    auto heuristic = [&](int n) { return abs(node_x(n) - gx) + abs(node_y(n) - gy); };
+
+    if (++q->generation == 0) {
+        std::fill(q->stamp.begin(), q->stamp.end(), 0);
+        q->generation = 1;
+    }
+    const uint32_t gen = q->generation;
+    std::vector<PathHeapEntry>& open = q->open;
+    open.clear();
+
+    q->stamp[S]  = gen;
+    q->gCost[S]  = 0;
+    q->parent[S] = -1;
+    open.push_back({ heuristic(S), heuristic(S), S });
+
+    auto relax = [&](int from, int to, int32_t cost) {
+        int32_t ng = q->gCost[from] + cost;
+        if (q->stamp[to] == gen && ng >= q->gCost[to]) return;
+        q->stamp[to]  = gen;
+        q->gCost[to]  = ng;
+        q->parent[to] = from;
+        int32_t h = heuristic(to);
+        open.push_back({ ng + h, h, to });
+        std::push_heap(open.begin(), open.end(), PathHeapEntry_After);
+    };
+
+    bool found = false;
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), PathHeapEntry_After);
+        PathHeapEntry top = open.back();
+        open.pop_back();
+
+        const int cur = top.idx;
+        if (top.f - top.h != q->gCost[cur]) continue; // stale
+
+        q->lastAbstractExpanded++;
+        if (cur == G) { found = true; break; }
+
+        if (cur == S) {
+            for (const HpaEdge& e : q->startEdges) relax(S, e.to, e.cost);
+            continue;
+        }
+        for (int i = hg->edgeStart[cur]; i < hg->edgeStart[cur + 1]; ++i)
+            relax(cur, hg->edges[i].to, hg->edges[i].cost);
+        if (hg->nodeCluster[cur] == gc) {
+            for (const HpaEdge& e : q->goalEdges)
+                if (e.to == cur) { relax(cur, G, e.cost); break; }
+        }
+    }
+
+    if (!found) return false;
+
+    q->route.clear();
+    for (int n = G; n != -1; n = q->parent[n]) q->route.push_back(n);
+    std::reverse(q->route.begin(), q->route.end());
+
+    // Lazy refinement: only turn the first hops into tiles
+    int fx = sx, fy = sy;
+    for (size_t i = 1; i < q->route.size(); ++i) {
+        int tx = node_x(q->route[i]);
+        int ty = node_y(q->route[i]);
+
+        if (cluster_of(hg, fx, fy) == cluster_of(hg, tx, ty)) {
+            int x0, y0, x1, y1;
+            cluster_rect(g, tx, ty, &x0, &y0, &x1, &y1);
+            bool ok = AStar_AppendPathInRect(ctx, g, fx, fy, tx, ty, x0, y0, x1, y1, outPath);
+            q->lastRefineExpanded += ctx->lastExpanded;
+            if (!ok) break;
+        } else {
+            outPath.push_back(tile_center(tx, ty)); // border crossing, tiles are adjacent
+        }
+
+        fx = tx;
+        fy = ty;
+        if ((int)outPath.size() >= kRefineTiles) break;
+    }
+    return !outPath.empty();
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "pathfinding.h"
+#include <cstdint>
+#include <vector>
+
+// HPA*: the grid is cut into square clusters. Every walkable opening on a cluster border
+// gets an entrance node on each side; nodes in the same cluster are joined by their
+// precomputed in-cluster distance. Long queries search this small graph and only the
+// first few hops are refined into tiles, the enemy repaths long before it needs the rest.
+#define HPA_CLUSTER_SIZE 16
+
+struct HpaEdge {
+    int32_t to;
+    int32_t cost;   // tiles
+};
+
+// Built once per level, read-only afterwards (safe to share between threads)
+struct HpaGraph {
+    int w = 0, h = 0;                  // grid size the graph was built for (0 = not built)
+    int clustersX = 0, clustersY = 0;
+
+    // Abstract graph (CSR adjacency)
+    std::vector<int32_t> nodeTile;     // node -> tile index
+    std::vector<int32_t> nodeCluster;  // node -> cluster index
+    std::vector<int32_t> edgeStart;    // node -> first edge, size nodes+1
+    std::vector<HpaEdge> edges;
+    std::vector<int32_t> clusterStart; // cluster -> first entry in clusterNodes, size clusters+1
+    std::vector<int32_t> clusterNodes;
+};
+
+// Per-thread query scratch
+struct HpaQuery {
+    // Abstract search, indexed by node; the two extra slots hold the inserted start/goal
+    uint32_t generation = 0;
+    std::vector<uint32_t> stamp;
+    std::vector<int32_t>  gCost;
+    std::vector<int32_t>  parent;
+    std::vector<PathHeapEntry> open;
+    std::vector<HpaEdge> startEdges;   // start -> entrances of its cluster
+    std::vector<HpaEdge> goalEdges;    // entrances of the goal's cluster -> goal
+    std::vector<int32_t> route;        // abstract result, start to goal
+
+    // Cluster-local BFS (HPA_CLUSTER_SIZE^2)
+    uint32_t bfsGeneration = 0;
+    std::vector<uint32_t> bfsStamp;
+    std::vector<int32_t>  bfsDist;
+    std::vector<int32_t>  bfsQueue;
+
+    // Instrumentation for the most recent Hpa_FindPath
+    uint32_t lastAbstractExpanded = 0;  // abstract nodes popped
+    uint32_t lastRefineExpanded   = 0;  // tiles popped while refining / short-range A*
+};
+
+// Builds the abstract graph for g. Call once per level (or after tiles change).
+void Hpa_Build(HpaGraph* hg, const Grid* g);
+
+// Path toward goalPx. Short queries run plain A*; long ones return only the refined
+// leading part of the route (it still ends on the way to the goal, not at it).
+bool Hpa_FindPath(const HpaGraph* hg, HpaQuery* q, PathContext* ctx, const Grid* g,
+                  Vector2 startPx, Vector2 goalPx, std::vector<Vector2>& outPath);
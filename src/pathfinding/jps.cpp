@@ -0,0 +1,207 @@
+#include "jps.h"
+#include "path_common.h"
+#include <algorithm>
+#include <cstdlib>
+
+static_assert(JPS_RIGHT == 0 && JPS_LEFT == 1 && JPS_DOWN == 2 && JPS_UP == 3,
+              "kDirs is indexed by JpsDir");
+
+// Entering (x,y) horizontally from (x-dx,y): does a vertical move become necessary here?
+static inline bool forced_horizontal(const Grid* g, int x, int y, int dx) {
+    return (is_floor(g, x, y - 1) && !is_floor(g, x - dx, y - 1)) ||
+           (is_floor(g, x, y + 1) && !is_floor(g, x - dx, y + 1));
+}
+
+void Jps_Build(JpsTables* jt, const Grid* g) {
+    jt->w = jt->h = 0;
+    jt->cells.clear();
+    if (!g || g->w <= 0 || g->h <= 0 || g->w > INT16_MAX || g->h > INT16_MAX) return;
+
+    const int W = g->w, H = g->h;
+    jt->w = W;
+    jt->h = H;
+    jt->cells.assign((size_t)W * H, JpsCell{});
+    JpsCell* c = jt->cells.data();
+
+    // Horizontal: walk each row against the scan direction so the neighbour is already done
+    for (int y = 0; y < H; ++y) {
+        for (int x = W - 1; x >= 0; --x) {
+            JpsCell& cell = c[y * W + x];
+            if (!is_floor(g, x + 1, y)) { cell.wall[JPS_RIGHT] = 0; cell.jump[JPS_RIGHT] = 0; continue; }
+            const JpsCell& next = c[y * W + x + 1];
+            cell.wall[JPS_RIGHT] = next.wall[JPS_RIGHT] + 1;
+            cell.jump[JPS_RIGHT] = forced_horizontal(g, x + 1, y, 1) ? 1
+                                 : next.jump[JPS_RIGHT] ? next.jump[JPS_RIGHT] + 1 : 0;
+        }
+        for (int x = 0; x < W; ++x) {
+            JpsCell& cell = c[y * W + x];
+            if (!is_floor(g, x - 1, y)) { cell.wall[JPS_LEFT] = 0; cell.jump[JPS_LEFT] = 0; continue; }
+            const JpsCell& next = c[y * W + x - 1];
+            cell.wall[JPS_LEFT] = next.wall[JPS_LEFT] + 1;
+            cell.jump[JPS_LEFT] = forced_horizontal(g, x - 1, y, -1) ? 1
+                                : next.jump[JPS_LEFT] ? next.jump[JPS_LEFT] + 1 : 0;
+        }
+    }
+
+    // Vertical: stop on the first row where a horizontal scan finds a jump point
+    auto stops_row = [&](const JpsCell& cell) { return cell.jump[JPS_LEFT] || cell.jump[JPS_RIGHT]; };
+    for (int x = 0; x < W; ++x) {
+        for (int y = H - 1; y >= 0; --y) {
+            JpsCell& cell = c[y * W + x];
+            if (!is_floor(g, x, y + 1)) { cell.wall[JPS_DOWN] = 0; cell.jump[JPS_DOWN] = 0; continue; }
+            const JpsCell& next = c[(y + 1) * W + x];
+            cell.wall[JPS_DOWN] = next.wall[JPS_DOWN] + 1;
+            cell.jump[JPS_DOWN] = stops_row(next) ? 1
+                                : next.jump[JPS_DOWN] ? next.jump[JPS_DOWN] + 1 : 0;
+        }
+        for (int y = 0; y < H; ++y) {
+            JpsCell& cell = c[y * W + x];
+            if (!is_floor(g, x, y - 1)) { cell.wall[JPS_UP] = 0; cell.jump[JPS_UP] = 0; continue; }
+            const JpsCell& next = c[(y - 1) * W + x];
+            cell.wall[JPS_UP] = next.wall[JPS_UP] + 1;
+            cell.jump[JPS_UP] = stops_row(next) ? 1
+                              : next.jump[JPS_UP] ? next.jump[JPS_UP] + 1 : 0;
+        }
+    }
+}
+
+// Steps from (x,y) in dir to the next jump point or the goal; 0 if the jump runs into a wall
+static int jump(const JpsTables* jt, int x, int y, JpsDir dir, int gx, int gy) {
+    const JpsCell* c = jt->cells.data();
+    const JpsCell& cell = c[y * jt->w + x];
+    const int reach = cell.wall[dir];
+    int k = cell.jump[dir];
+
+    // Goal on the way? Horizontally it has to be in this row; vertically it has to be
+    // visible from the column in its own row.
+    int kg = 0;
+    if (dir == JPS_RIGHT || dir == JPS_LEFT) {
+        int d = (dir == JPS_RIGHT) ? gx - x : x - gx;
+        if (gy == y && d > 0 && d <= reach) kg = d;
+    } else {
+        int d = (dir == JPS_DOWN) ? gy - y : y - gy;
+        if (d > 0 && d <= reach) {
+            const JpsCell& row = c[gy * jt->w + x];
+            bool visible = (gx == x) ||
+                           (gx > x && gx - x <= row.wall[JPS_RIGHT]) ||
+                           (gx < x && x - gx <= row.wall[JPS_LEFT]);
+            if (visible) kg = d;
+        }
+    }
+
+    if (kg && (!k || kg < k)) k = kg;
+    return k;
+}
+
+bool Jps_FindPath(PathContext* ctx, const JpsTables* jt, const Grid* g, Vector2 startPx, Vector2 goalPx,
+                  std::vector<Vector2>& outPath) {
+    outPath.clear();
+    ctx->lastExpanded = 0;
+
+    int sx = (int)(startPx.x / TILE_SIZE);
+    int sy = (int)(startPx.y / TILE_SIZE);
+    int gx = (int)(goalPx.x / TILE_SIZE);
+    int gy = (int)(goalPx.y / TILE_SIZE);
+
+    if (jt->w != g->w || jt->h != g->h) return false;
+    if (!in_bounds(g, sx, sy)) return false;
+    if (sx == gx && sy == gy) return true;
+    if (!is_floor(g, gx, gy)) return false;
+
+    if (ctx->w != g->w || ctx->h != g->h) PathContext_Reserve(ctx, g);
+    if (++ctx->generation == 0) {
+        std::fill(ctx->stamp.begin(), ctx->stamp.end(), 0);
+        ctx->generation = 1;
+    }
+    const uint32_t gen = ctx->generation;
+
+    const int W = g->w;
+    uint32_t* stamp   = ctx->stamp.data();
+    int32_t*  gCost   = ctx->gCost.data();
+    int32_t*  parent  = ctx->parent.data();
+    uint8_t*  arrival = ctx->arrival.data();
+    std::vector<PathHeapEntry>& open = ctx->open;
+    open.clear();
+
+    const int start = grid_idx(g, sx, sy);
+    const int goal  = grid_idx(g, gx, gy);
+
+    stamp[start]   = gen;
+    gCost[start]   = 0;
+    parent[start]  = -1;
+    arrival[start] = JPS_NONE;
+    int32_t h0 = abs(sx - gx) + abs(sy - gy);
+    open.push_back({ h0, h0, start });
+
+    auto push = [&](int from, int x, int y, JpsDir dir) {
+        int k = jump(jt, x, y, dir, gx, gy);
+        if (!k) return;
+        int nx = x + kDirs[dir][0] * k;
+        int ny = y + kDirs[dir][1] * k;
+        int ni = ny * W + nx;
+        int32_t ng = gCost[from] + k;
+        if (stamp[ni] == gen && ng >= gCost[ni]) return;
+
+        stamp[ni]   = gen;
+        gCost[ni]   = ng;
+        parent[ni]  = from;
+        arrival[ni] = dir;
+        int32_t h = abs(nx - gx) + abs(ny - gy);
+        open.push_back({ ng + h, h, ni });
+        std::push_heap(open.begin(), open.end(), PathHeapEntry_After);
+    };
+
+    bool found = false;
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), PathHeapEntry_After);
+        PathHeapEntry top = open.back();
+        open.pop_back();
+
+        const int cur = top.idx;
+        if (top.f - top.h != gCost[cur]) continue; // stale
+
+        ctx->lastExpanded++;
+        if (cur == goal) { found = true; break; }
+
+        const int cx = cur % W;
+        const int cy = cur / W;
+        switch (arrival[cur]) {
+            case JPS_RIGHT:
+            case JPS_LEFT: {
+                JpsDir d = (JpsDir)arrival[cur];
+                int dx = kDirs[d][0];
+                push(cur, cx, cy, d);
+                if (is_floor(g, cx, cy - 1) && !is_floor(g, cx - dx, cy - 1)) push(cur, cx, cy, JPS_UP);
+                if (is_floor(g, cx, cy + 1) && !is_floor(g, cx - dx, cy + 1)) push(cur, cx, cy, JPS_DOWN);
+            } break;
+            case JPS_DOWN:
+            case JPS_UP:
+                push(cur, cx, cy, (JpsDir)arrival[cur]);
+                push(cur, cx, cy, JPS_RIGHT);
+                push(cur, cx, cy, JPS_LEFT);
+                break;
+            default: // start: every direction is natural
+                push(cur, cx, cy, JPS_RIGHT);
+                push(cur, cx, cy, JPS_LEFT);
+                push(cur, cx, cy, JPS_DOWN);
+                push(cur, cx, cy, JPS_UP);
+                break;
+        }
+    }
+
+    if (!found) return false;
+
+    // Jump points are joined by straight runs; expand them back into tiles
+    outPath.resize((size_t)gCost[goal]);
+    size_t i = outPath.size();
+    for (int cur = goal; cur != start; cur = parent[cur]) {
+        const int* step = kDirs[arrival[cur]];
+        int x = cur % W, y = cur / W;
+        for (int k = gCost[cur] - gCost[parent[cur]]; k > 0; --k) {
+            outPath[--i] = tile_center(x, y);
+            x -= step[0];
+            y -= step[1];
+        }
+    }
+    return true;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include "pathfinding.h"
+#include <cstdint>
+#include <vector>
+
+// Jump Point Search for our 4-connected, uniform-cost grid (JPS+ style: jump distances are
+// precomputed per tile, so every jump is a handful of table reads).
+//
+// Canonical paths turn from vertical to horizontal freely, but from horizontal to vertical
+// only at "forced" tiles where the row beside them opens up. Horizontal jumps therefore stop
+// at forced tiles; vertical jumps stop on any row whose horizontal scan would stop.
+
+enum JpsDir : uint8_t { JPS_RIGHT = 0, JPS_LEFT = 1, JPS_DOWN = 2, JPS_UP = 3, JPS_NONE = 4 };
+
+// Per-tile jump data, stored in a w*h array alongside Grid::t
+struct JpsCell {
+    int16_t wall[4];   // free steps before a wall / map edge, per JpsDir
+    int16_t jump[4];   // steps to the next jump point per JpsDir, 0 = none before the wall
+};
+
+struct JpsTables {
+    int w = 0, h = 0;   // grid size the tables were built for (0 = not built)
+    std::vector<JpsCell> cells;
+};
+
+// Precomputes the tables. Only needs to run again when tiles change.
+void Jps_Build(JpsTables* jt, const Grid* g);
+
+// Drop-in for AStar_FindPath: same path length, far fewer expanded nodes on open areas.
+bool Jps_FindPath(PathContext* ctx, const JpsTables* jt, const Grid* g, Vector2 startPx, Vector2 goalPx,
+                  std::vector<Vector2>& outPath);
@@ -0,0 +1,15 @@
+#pragma once
+#include "raylib.h"
+#include "../level/level.h"
+
+// Tile helpers shared by the search implementations; internal to src/pathfinding.
+
+static const int kDirs[4][2] = { {1,0},{-1,0},{0,1},{0,-1} };
+
+static inline bool is_floor(const Grid* g, int x, int y) {
+    return grid_walkable(g, x, y);
+}
+
+static inline Vector2 tile_center(int x, int y) {
+    return { x * (float)TILE_SIZE + TILE_SIZE * 0.5f, y * (float)TILE_SIZE + TILE_SIZE * 0.5f };
+}
@@ -0,0 +1,476 @@
+#include "pathfinding.h"
+#include "hpa.h"
+#include "jps.h"
+#include "path_common.h"
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+
+const char* PathMode_Name(PathMode mode) {
+    switch (mode) {
+        case PathMode::AStar:        return "A*";
+        case PathMode::FlowField:    return "FlowField";
+        case PathMode::Hierarchical: return "HPA*";
+        case PathMode::JumpPoint:    return "JPS+";
+    }
+    return "?";
+}
+
+PathMode PathMode_Next(PathMode mode) {
+    switch (mode) {
+        case PathMode::AStar:        return PathMode::FlowField;
+        case PathMode::FlowField:    return PathMode::Hierarchical;
+        case PathMode::Hierarchical: return PathMode::JumpPoint;
+        case PathMode::JumpPoint:    return PathMode::AStar;
+    }
+    return PathMode::AStar;
+}
+
+static inline int32_t Heuristic(int x1, int y1, int x2, int y2) {
+    return abs(x1 - x2) + abs(y1 - y2); // Manhattan
+}
+
+// Per-thread search scratch; [0] belongs to the main thread
+struct PathWorker {
+    PathContext     ctx;
+    HpaQuery        hpa;
+    PathSearchStats stats;   // only this worker writes it
+};
+
+static std::vector<PathWorker> g_workers(1);
+static std::vector<int32_t>    g_batchPending;
+static HpaGraph                g_levelGraph;
+static JpsTables               g_jumpTables;
+
+PathCache g_pathCache;
+
+void PathContext_Reserve(PathContext* ctx, const Grid* g) {
+    const size_t N = (size_t)g->w * g->h;
+    ctx->w = g->w;
+    ctx->h = g->h;
+    ctx->generation = 0;
+    ctx->stamp.assign(N, 0);
+    ctx->gCost.assign(N, 0);
+    ctx->parent.assign(N, -1);
+    ctx->arrival.assign(N, 0);
+    ctx->open.clear();
+    ctx->open.reserve(N / 4 + 64);
+}
+
+// A* PATHFIND 
+bool AStar_AppendPathInRect(PathContext* ctx, const Grid* g, int sx, int sy, int gx, int gy,
+                            int x0, int y0, int x1, int y1, std::vector<Vector2>& outPath) {
+    ctx->lastExpanded = 0;
+
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > g->w) x1 = g->w;
+    if (y1 > g->h) y1 = g->h;
+    auto in_rect = [&](int x, int y) { return x >= x0 && y >= y0 && x < x1 && y < y1; };
+
+    if (!in_rect(sx, sy) || !in_rect(gx, gy)) return false;
+    if (sx == gx && sy == gy) return true;
+    if (!is_floor(g, gx, gy)) return false; // goal can never be entered
+
+    if (ctx->w != g->w || ctx->h != g->h) PathContext_Reserve(ctx, g);
+
+    // Bump the generation instead of clearing; on wrap-around do one real clear
+    if (++ctx->generation == 0) {
+        std::fill(ctx->stamp.begin(), ctx->stamp.end(), 0);
+        ctx->generation = 1;
+    }
+    const uint32_t gen = ctx->generation;
+
+    const int W = g->w;
+    uint32_t* stamp  = ctx->stamp.data();
+    int32_t*  gCost  = ctx->gCost.data();
+    int32_t*  parent = ctx->parent.data();
+    std::vector<PathHeapEntry>& open = ctx->open;
+    open.clear();
+
+    const int start = grid_idx(g, sx, sy);
+    const int goal  = grid_idx(g, gx, gy);
+
+    stamp[start]  = gen;
+    gCost[start]  = 0;
+    parent[start] = -1;
+    int32_t h0 = Heuristic(sx, sy, gx, gy);
+    open.push_back({ h0, h0, start });
+
+    bool found = false;
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), PathHeapEntry_After);
+        PathHeapEntry top = open.back();
+        open.pop_back();
+
+        const int cur = top.idx;
+        const int32_t curG = gCost[cur];
+        if (top.f - top.h != curG) continue; // stale entry, a cheaper one was pushed later
+
+        ctx->lastExpanded++;
+        if (cur == goal) { found = true; break; }
+
+        const int cx = cur % W;
+        const int cy = cur / W;
+        for (auto& d : kDirs) {
+            int nx = cx + d[0];
+            int ny = cy + d[1];
+            if (!in_rect(nx, ny) || !is_floor(g, nx, ny)) continue;
+
+            int ni = grid_idx(g, nx, ny);
+            int32_t newG = curG + 1;
+            if (stamp[ni] == gen && newG >= gCost[ni]) continue;
+
+            stamp[ni]  = gen;
+            gCost[ni]  = newG;
+            parent[ni] = cur;
+
+            int32_t h = Heuristic(nx, ny, gx, gy);
+            open.push_back({ newG + h, h, ni });
+            std::push_heap(open.begin(), open.end(), PathHeapEntry_After);
+        }
+    }
+
+    if (!found) return false;
+
+    // Path length is the goal's g, so grow the caller's vector once and fill it back to front
+    const size_t base = outPath.size();
+    outPath.resize(base + (size_t)gCost[goal]);
+    size_t i = outPath.size();
+    for (int cur = goal; cur != start; cur = parent[cur])
+        outPath[--i] = tile_center(cur % W, cur / W);
+    return true;
+}
+
+bool AStar_FindPath(PathContext* ctx, const Grid* g, Vector2 startPx, Vector2 goalPx, std::vector<Vector2>& outPath) {
+    outPath.clear();
+
+    int sx = (int)(startPx.x / TILE_SIZE);
+    int sy = (int)(startPx.y / TILE_SIZE);
+    int gx = (int)(goalPx.x / TILE_SIZE);
+    int gy = (int)(goalPx.y / TILE_SIZE);
+
+    return AStar_AppendPathInRect(ctx, g, sx, sy, gx, gy, 0, 0, g->w, g->h, outPath);
+}
+
+bool AStar_FindPath(const Grid* g, Vector2 startPx, Vector2 goalPx, std::vector<Vector2>& outPath) {
+    return AStar_FindPath(&g_workers[0].ctx, g, startPx, goalPx, outPath);
+}
+
+void Pathfinding_SetLevel(const Grid* g) {
+    if (!g) return;
+    for (PathWorker& w : g_workers) PathContext_Reserve(&w.ctx, g);
+    Hpa_Build(&g_levelGraph, g);
+    Jps_Build(&g_jumpTables, g);
+    PathCache_Reserve(&g_pathCache, g);
+}
+
+static bool FindOn(PathWorker* w, PathMode mode, const Grid* g, Vector2 startPx, Vector2 goalPx,
+                   std::vector<Vector2>& outPath) {
+    bool found;
+    switch (mode) {
+        case PathMode::Hierarchical:
+            if (g_levelGraph.w != g->w || g_levelGraph.h != g->h) break; // graph not built for this grid yet
+            found = Hpa_FindPath(&g_levelGraph, &w->hpa, &w->ctx, g, startPx, goalPx, outPath);
+            w->stats.hpaSearches++;
+            w->stats.hpaAbstractExpanded += w->hpa.lastAbstractExpanded;
+            w->stats.hpaRefineExpanded   += w->hpa.lastRefineExpanded;
+            return found;
+        case PathMode::JumpPoint:
+            if (g_jumpTables.w != g->w || g_jumpTables.h != g->h) break;
+            found = Jps_FindPath(&w->ctx, &g_jumpTables, g, startPx, goalPx, outPath);
+            w->stats.searches++;
+            w->stats.expanded += w->ctx.lastExpanded;
+            return found;
+        case PathMode::AStar:
+        case PathMode::FlowField:
+            break;
+    }
+    found = AStar_FindPath(&w->ctx, g, startPx, goalPx, outPath);
+    w->stats.searches++;
+    w->stats.expanded += w->ctx.lastExpanded;
+    return found;
+}
+
+bool Path_Find(PathMode mode, const Grid* g, Vector2 startPx, Vector2 goalPx, std::vector<Vector2>& outPath) {
+    return FindOn(&g_workers[0], mode, g, startPx, goalPx, outPath);
+}
+
+PathSearchStats Path_SearchStats() {
+    PathSearchStats sum;
+    for (const PathWorker& w : g_workers) {
+        sum.searches            += w.stats.searches;
+        sum.expanded            += w.stats.expanded;
+        sum.hpaSearches         += w.stats.hpaSearches;
+        sum.hpaAbstractExpanded += w.stats.hpaAbstractExpanded;
+        sum.hpaRefineExpanded   += w.stats.hpaRefineExpanded;
+    }
+    return sum;
+}
+
+void Path_ResetSearchStats() {
+    for (PathWorker& w : g_workers) w.stats = PathSearchStats{};
+}
+
+// --- path cache --------------------------------------------------------
+
+static const int kDefaultPathCacheSize = 64;
+
+void PathCache_Init(PathCache* cache, int capacity) {
+    if (capacity < 1) capacity = 1;
+    cache->entries.assign((size_t)capacity, PathCacheEntry{});
+    std::fill(cache->onPath.begin(), cache->onPath.end(), PathCacheRef{ -1, 0 });
+    cache->goalTile = -1;
+    cache->clock = 0;
+}
+
+void PathCache_Reserve(PathCache* cache, const Grid* g) {
+    if (cache->entries.empty()) PathCache_Init(cache, kDefaultPathCacheSize);
+    for (PathCacheEntry& e : cache->entries) e.tiles.clear();
+    cache->onPath.assign((size_t)g->w * g->h, PathCacheRef{ -1, 0 });
+    cache->goalTile = -1;
+}
+
+static void PathCache_Evict(PathCache* cache, int32_t slot) {
+    PathCacheEntry& e = cache->entries[slot];
+    for (int32_t t : e.tiles)
+        if (cache->onPath[t].entry == slot) cache->onPath[t].entry = -1;
+    e.tiles.clear(); // keeps its capacity for the next path in this slot
+}
+
+// Only the tiles of cached paths are marked, so this is O(cached tiles), not O(grid)
+void PathCache_Clear(PathCache* cache) {
+    for (int32_t slot = 0; slot < (int32_t)cache->entries.size(); ++slot)
+        PathCache_Evict(cache, slot);
+    cache->goalTile = -1;
+}
+
+static bool Cacheable(PathMode mode) {
+    return mode == PathMode::AStar || mode == PathMode::JumpPoint;
+}
+
+// Start/goal tile indices, or false if either is off the grid
+static bool CacheKey(const Grid* g, Vector2 startPx, Vector2 goalPx, int32_t* start, int32_t* goal) {
+    int sx = (int)(startPx.x / TILE_SIZE);
+    int sy = (int)(startPx.y / TILE_SIZE);
+    int gx = (int)(goalPx.x / TILE_SIZE);
+    int gy = (int)(goalPx.y / TILE_SIZE);
+    if (!in_bounds(g, sx, sy) || !in_bounds(g, gx, gy)) return false;
+    *start = grid_idx(g, sx, sy);
+    *goal  = grid_idx(g, gx, gy);
+    return true;
+}
+
+// Serves the query from the cache if possible (counting a miss otherwise). Switches the
+// cache over to a new goal tile first.
+static bool PathCache_Lookup(PathCache* cache, const Grid* g, int32_t start, int32_t goal,
+                             std::vector<Vector2>& outPath) {
+    if (cache->onPath.size() != (size_t)g->w * g->h) PathCache_Reserve(cache, g);
+
+    if (goal != cache->goalTile) {
+        bool cached = false;
+        for (const PathCacheEntry& e : cache->entries) cached |= !e.tiles.empty();
+        if (cached) cache->stats.invalidations++;
+        PathCache_Clear(cache);
+        cache->goalTile = goal;
+    }
+
+    cache->clock++;
+
+    const PathCacheRef hit = cache->onPath[start];
+    if (hit.entry < 0) {
+        cache->stats.misses++;
+        return false;
+    }
+
+    PathCacheEntry& e = cache->entries[hit.entry];
+    const int32_t pos = hit.pos;
+    if (pos == 0) cache->stats.hits++;
+    else          cache->stats.suffixHits++;
+    e.lastUse = cache->clock;
+
+    outPath.resize(e.tiles.size() - (size_t)pos - 1);
+    for (size_t i = 0; i < outPath.size(); ++i) {
+        int32_t t = e.tiles[(size_t)pos + 1 + i];
+        outPath[i] = tile_center(t % g->w, t / g->w);
+    }
+    return true;
+}
+
+static void PathCache_Insert(PathCache* cache, const Grid* g, int32_t start, int32_t goal,
+                             const std::vector<Vector2>& path) {
+    if (path.empty() || goal != cache->goalTile) return;
+
+    // Reuse a free slot, otherwise the least recently used one
+    int32_t slot = 0;
+    for (int32_t i = 0; i < (int32_t)cache->entries.size(); ++i) {
+        const PathCacheEntry& e = cache->entries[i];
+        if (e.tiles.empty()) { slot = i; break; }
+        if (e.lastUse < cache->entries[slot].lastUse) slot = i;
+    }
+    PathCache_Evict(cache, slot);
+
+    PathCacheEntry& e = cache->entries[slot];
+    e.lastUse = cache->clock;
+    e.tiles.push_back(start);
+    for (const Vector2& p : path)
+        e.tiles.push_back(grid_idx(g, (int)(p.x / TILE_SIZE), (int)(p.y / TILE_SIZE)));
+
+    // The goal tile has no tail worth caching
+    for (int32_t i = 0; i + 1 < (int32_t)e.tiles.size(); ++i)
+        cache->onPath[e.tiles[i]] = { slot, i };
+}
+
+bool Path_FindCached(PathCache* cache, PathMode mode, const Grid* g, Vector2 startPx, Vector2 goalPx,
+                     std::vector<Vector2>& outPath) {
+    int32_t start, goal;
+    if (!Cacheable(mode) || !CacheKey(g, startPx, goalPx, &start, &goal))
+        return Path_Find(mode, g, startPx, goalPx, outPath);
+
+    if (PathCache_Lookup(cache, g, start, goal, outPath)) return true;
+    if (!Path_Find(mode, g, startPx, goalPx, outPath)) return false;
+
+    PathCache_Insert(cache, g, start, goal, outPath);
+    return true;
+}
+
+// --- batches -----------------------------------------------------------
+
+struct BatchJob {
+    PathMode     mode;
+    const Grid*  grid;
+    PathRequest* reqs;
+    const int32_t* pending;    // indices into reqs that still need a search
+};
+
+static void BatchRange(int32_t begin, int32_t end, uint32_t worker, void* user) {
+    BatchJob* job = (BatchJob*)user;
+    PathWorker* w = &g_workers[worker];
+    for (int32_t i = begin; i < end; ++i) {
+        PathRequest& r = job->reqs[job->pending[i]];
+        r.found = FindOn(w, job->mode, job->grid, r.startPx, r.goalPx, *r.out);
+    }
+}
+
+void Path_FindBatch(PathCache* cache, PathMode mode, const Grid* g, PathRequest* reqs, int32_t count,
+                    JobSystem* jobs) {
+    if (count <= 0) return;
+
+    const int workers = Jobs_WorkerCount(jobs);
+    if ((int)g_workers.size() < workers) g_workers.resize((size_t)workers);
+
+    // Cache reads and writes stay on this thread and in request order, so the outcome does
+    // not depend on how the searches were spread over workers.
+    const bool useCache = cache && Cacheable(mode);
+    g_batchPending.clear();
+    for (int32_t i = 0; i < count; ++i) {
+        PathRequest& r = reqs[i];
+        r.found = false;
+        int32_t start, goal;
+        if (useCache && CacheKey(g, r.startPx, r.goalPx, &start, &goal) &&
+            PathCache_Lookup(cache, g, start, goal, *r.out)) {
+            r.found = true;
+            continue;
+        }
+        g_batchPending.push_back(i);
+    }
+
+    BatchJob job = { mode, g, reqs, g_batchPending.data() };
+    Jobs_ParallelFor(jobs, (int32_t)g_batchPending.size(), 1, BatchRange, &job);
+
+    if (!useCache) return;
+    for (int32_t i : g_batchPending) {
+        PathRequest& r = reqs[i];
+        int32_t start, goal;
+        if (r.found && CacheKey(g, r.startPx, r.goalPx, &start, &goal))
+            PathCache_Insert(cache, g, start, goal, *r.out);
+    }
+}
+
+// --- flow field --------------------------------------------------------
+
+void FlowField_Invalidate(FlowField* ff) {
+    ff->goalX = -1;
+    ff->goalY = -1;
+}
+
+bool FlowField_Update(FlowField* ff, const Grid* g, Vector2 goalPx) {
+    if (!ff || !g || g->w <= 0 || g->h <= 0) return false;
+
+    int gx = (int)(goalPx.x / TILE_SIZE);
+    int gy = (int)(goalPx.y / TILE_SIZE);
+    if (!in_bounds(g, gx, gy)) return false;
+
+    const int N = g->w * g->h;
+    if (ff->w != g->w || ff->h != g->h) {
+        ff->w = g->w;
+        ff->h = g->h;
+        ff->dist.assign(N, -1);
+        ff->queue.assign(N, 0);
+        FlowField_Invalidate(ff);
+    }
+
+    // Same tile as last build -> the field is still valid
+    if (gx == ff->goalX && gy == ff->goalY) return false;
+    ff->goalX = gx;
+    ff->goalY = gy;
+
+    std::fill(ff->dist.begin(), ff->dist.end(), -1);
+
+    // Uniform cost, so plain BFS gives the same distances as Dijkstra.
+    // The goal is seeded even if it's a wall tile (player hugging an edge).
+    int32_t* dist = ff->dist.data();
+    int32_t* q    = ff->queue.data();
+    int head = 0, tail = 0;
+
+    int goal = grid_idx(g, gx, gy);
+    dist[goal] = 0;
+    q[tail++] = goal;
+
+    while (head < tail) {
+        int cur = q[head++];
+        int cx = cur % g->w;
+        int cy = cur / g->w;
+        int nd = dist[cur] + 1;
+
+        for (auto& d : kDirs) {
+            int nx = cx + d[0];
+            int ny = cy + d[1];
+            if (!is_floor(g, nx, ny)) continue;
+
+            int ni = grid_idx(g, nx, ny);
+            if (dist[ni] != -1) continue;
+            dist[ni] = nd;
+            q[tail++] = ni;
+        }
+    }
+    return true;
+}
+
+bool FlowField_Sample(const FlowField* ff, Vector2 posPx, Vector2* outTargetPx) {
+    if (!ff || ff->goalX < 0 || ff->dist.empty()) return false;
+
+    int x = (int)(posPx.x / TILE_SIZE);
+    int y = (int)(posPx.y / TILE_SIZE);
+    if (x < 0 || y < 0 || x >= ff->w || y >= ff->h) return false;
+
+    const int32_t* dist = ff->dist.data();
+    int32_t here = dist[y * ff->w + x];
+    if (here == 0) return false; // already on the goal tile
+
+    // Bodies can get pushed into a wall tile (dist -1); still step toward any reachable neighbour
+    int32_t best = (here > 0) ? here : INT32_MAX;
+    int bx = -1, by = -1;
+    for (auto& d : kDirs) {
+        int nx = x + d[0];
+        int ny = y + d[1];
+        if (nx < 0 || ny < 0 || nx >= ff->w || ny >= ff->h) continue;
+
+        int32_t nd = dist[ny * ff->w + nx];
+        if (nd >= 0 && nd < best) { best = nd; bx = nx; by = ny; }
+    }
+    if (bx < 0) return false;
+
+    *outTargetPx = tile_center(bx, by);
+    return true;
+}
@@ -0,0 +1,156 @@
+#pragma once
+#include "raylib.h"
+#include "../level/level.h"
+#include "../jobs/jobs.h"
+#include <cstdint>
+#include <vector>
+
+// How enemies find their way to the player when there is no line of sight.
+enum class PathMode : uint8_t {
+    AStar,      // every enemy runs its own A* search on repath
+    FlowField,  // one shared distance map from the player's tile, sampled per enemy
+    Hierarchical, // HPA*: cluster graph for long queries, refined near the enemy
+    JumpPoint,    // JPS+: A* over precomputed jump points, same paths as AStar
+};
+
+const char* PathMode_Name(PathMode mode);
+PathMode    PathMode_Next(PathMode mode);   // cycles through all modes
+
+struct PathHeapEntry {
+    int32_t f;     // g + h
+    int32_t h;     // tie-break: prefer nodes closer to the goal
+    int32_t idx;   // tile index
+};
+
+// Ordering for std::push_heap/pop_heap: smallest f, then smallest h, then index (deterministic).
+inline bool PathHeapEntry_After(const PathHeapEntry& a, const PathHeapEntry& b) {
+    if (a.f != b.f) return a.f > b.f;
+    if (a.h != b.h) return a.h > b.h;
+    return a.idx > b.idx;
+}
+
+// Reusable A* scratch state. Node data lives in flat w*h arrays indexed by tile; a node
+// only counts as visited when its stamp matches the current search generation, so
+// nothing has to be cleared between searches and steady-state searches never allocate.
+struct PathContext {
+    int w = 0, h = 0;
+    uint32_t generation = 0;
+    std::vector<uint32_t> stamp;      // search generation that last touched the tile
+    std::vector<int32_t>  gCost;      // valid only when stamp == generation
+    std::vector<int32_t>  parent;     // tile index, -1 for the start
+    std::vector<uint8_t>  arrival;    // JPS: direction the node was reached from
+    std::vector<PathHeapEntry> open;  // binary heap, capacity kept between searches
+
+    uint32_t lastExpanded = 0;        // nodes popped by the most recent search
+};
+
+// Sizes the context for g. Called implicitly by AStar_FindPath when the grid size changes.
+void PathContext_Reserve(PathContext* ctx, const Grid* g);
+
+// 4-connected A* over floor tiles. Writes tile-center waypoints (start tile excluded)
+// straight into outPath, reusing its capacity.
+bool AStar_FindPath(PathContext* ctx, const Grid* g, Vector2 startPx, Vector2 goalPx, std::vector<Vector2>& outPath);
+
+// Same, using the shared main-thread context.
+bool AStar_FindPath(const Grid* g, Vector2 startPx, Vector2 goalPx, std::vector<Vector2>& outPath);
+
+// Tile-space A* restricted to the rect [x0,x1) x [y0,y1). Appends the waypoints after the
+// start tile to outPath without clearing it. Used to refine hierarchical paths.
+bool AStar_AppendPathInRect(PathContext* ctx, const Grid* g, int sx, int sy, int gx, int gy,
+                            int x0, int y0, int x1, int y1, std::vector<Vector2>& outPath);
+
+// LRU cache of recent paths toward one goal tile. A query whose start tile lies anywhere
+// on a cached path reuses that path's tail (a sub-path of a shortest path is shortest).
+// Everything is dropped when the goal moves to another tile.
+struct PathCacheStats {
+    uint64_t hits = 0;           // start tile was the start of a cached path
+    uint64_t suffixHits = 0;     // start tile was further along a cached path
+    uint64_t misses = 0;         // had to search
+    uint64_t invalidations = 0;  // goal changed tile, cache emptied
+};
+
+struct PathCacheEntry {
+    uint64_t lastUse = 0;
+    std::vector<int32_t> tiles;  // tile indices, start first, goal last; empty = free slot
+};
+
+struct PathCacheRef {
+    int32_t entry;               // -1 = no cached path through the tile
+    int32_t pos;                 // index into PathCacheEntry::tiles
+};
+
+struct PathCache {
+    int32_t goalTile = -1;
+    uint64_t clock = 0;
+    std::vector<PathCacheEntry> entries;   // fixed number of slots
+    std::vector<PathCacheRef> onPath;      // per tile: newest cached path through it
+    PathCacheStats stats;
+};
+
+extern PathCache g_pathCache;   // shared by enemy repaths
+
+void PathCache_Init(PathCache* cache, int capacity);
+void PathCache_Clear(PathCache* cache);
+
+// Sizes the per-tile table for g. Called implicitly on the first lookup on a grid of
+// another size; Pathfinding_SetLevel does it for g_pathCache.
+void PathCache_Reserve(PathCache* cache, const Grid* g);
+
+// Path_Find through the cache. HPA* results are partial and FlowField has no per-agent
+// query, so those modes bypass it.
+bool Path_FindCached(PathCache* cache, PathMode mode, const Grid* g, Vector2 startPx, Vector2 goalPx,
+                     std::vector<Vector2>& outPath);
+
+// One query of a batch. out must stay valid until Path_FindBatch returns.
+struct PathRequest {
+    Vector2 startPx;
+    Vector2 goalPx;
+    std::vector<Vector2>* out;
+    bool found;
+};
+
+// Solves independent queries across the job system's workers, each with its own search
+// scratch, and returns once every out vector is written. Cache lookups and inserts happen
+// on the calling thread in request order, so results don't depend on the thread count.
+void Path_FindBatch(PathCache* cache, PathMode mode, const Grid* g, PathRequest* reqs, int32_t count,
+                    JobSystem* jobs);
+
+// Rebuilds per-level search data (HPA* cluster graph, JPS+ jump tables). Call after
+// generating a level and whenever tiles change; nothing else rebuilds them.
+void Pathfinding_SetLevel(const Grid* g);
+
+// Nodes popped by the searches Path_Find and Path_FindBatch ran (cache hits don't count),
+// summed over every worker. HPA* queries count under the two hpa fields, not expanded.
+struct PathSearchStats {
+    uint64_t searches = 0;
+    uint64_t expanded = 0;              // A* and JPS+
+    uint64_t hpaSearches = 0;
+    uint64_t hpaAbstractExpanded = 0;   // cluster graph nodes
+    uint64_t hpaRefineExpanded = 0;     // tiles, refinement and short-range A*
+};
+
+PathSearchStats Path_SearchStats();
+void            Path_ResetSearchStats();
+
+// One path query in the given mode on the main-thread context. FlowField has no per-agent
+// query, so it falls back to A* here.
+bool Path_Find(PathMode mode, const Grid* g, Vector2 startPx, Vector2 goalPx, std::vector<Vector2>& outPath);
+
+// BFS distance map toward a single goal tile. Only rebuilt when the goal moves to a new tile,
+// so any number of agents can sample it in O(1).
+struct FlowField {
+    int w = 0, h = 0;
+    int goalX = -1, goalY = -1;
+    std::vector<int32_t> dist;   // steps to goal per tile, -1 = unreachable
+    std::vector<int32_t> queue;  // BFS scratch, kept around so rebuilds don't allocate
+};
+
+// Rebuilds the field if the goal changed tile (or the grid size changed). Returns true if rebuilt.
+bool FlowField_Update(FlowField* ff, const Grid* g, Vector2 goalPx);
+
+// Center of the neighbouring tile that is one step closer to the goal.
+// Returns false if posPx can't reach the goal or is already on the goal tile.
+bool FlowField_Sample(const FlowField* ff, Vector2 posPx, Vector2* outTargetPx);
+
+// Forces the next FlowField_Update to rebuild (e.g. after the level changed).
+void FlowField_Invalidate(FlowField* ff);
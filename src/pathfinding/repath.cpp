@@ -0,0 +1,65 @@
+#include "repath.h"
+#include <algorithm>
+#include <chrono>
+
+typedef std::chrono::steady_clock Clock;
+
+static inline bool RequestAfter(const RepathRequest& a, const RepathRequest& b) {
+    if (a.key != b.key) return a.key > b.key;
+    return a.agentId > b.agentId;
+}
+
+static inline float ElapsedUs(Clock::time_point since) {
+    return std::chrono::duration<float, std::micro>(Clock::now() - since).count();
+}
+
+void Repath_Clear(RepathScheduler* rs) {
+    rs->heap.clear();
+    rs->stats.queueDepth = 0;
+}
+
+void Repath_Enqueue(RepathScheduler* rs, int32_t agentId, float priority) {
+    // Aging is folded into the key at enqueue time: everything waiting ages at the same rate,
+    // so an older request only needs a head start proportional to how long it has waited.
+    float key = priority + (float)rs->frame * rs->agingPerFrame;
+    rs->heap.push_back({ agentId, key });
+    std::push_heap(rs->heap.begin(), rs->heap.end(), RequestAfter);
+}
+
+void Repath_Service(RepathScheduler* rs, RepathBatchFn fn, void* user) {
+    rs->frame++;
+
+    Clock::time_point t0 = Clock::now();
+    uint32_t serviced = 0;
+    float spent = 0.f;
+
+    while (!rs->heap.empty()) {
+        if (serviced > 0 && spent >= rs->budgetUs) break;
+
+        rs->batch.clear();
+        while (!rs->heap.empty() && rs->batch.size() < std::max<uint32_t>(rs->batchSize, 1)) {
+            std::pop_heap(rs->heap.begin(), rs->heap.end(), RequestAfter);
+            rs->batch.push_back(rs->heap.back().agentId);
+            rs->heap.pop_back();
+        }
+
+        serviced += fn(rs->batch.data(), (uint32_t)rs->batch.size(), user);
+        spent = ElapsedUs(t0);
+    }
+
+    rs->history[rs->historyCount % REPATH_FRAME_HISTORY] = spent;
+    rs->historyCount++;
+
+    uint32_t n = std::min<uint32_t>(rs->historyCount, REPATH_FRAME_HISTORY);
+    float sorted[REPATH_FRAME_HISTORY];
+    std::copy(rs->history, rs->history + n, sorted);
+    uint32_t k = (n * 99) / 100;
+    if (k >= n) k = n - 1;
+    std::nth_element(sorted, sorted + k, sorted + n);
+
+    rs->stats.queueDepth    = (uint32_t)rs->heap.size();
+    rs->stats.servicedLast  = serviced;
+    rs->stats.lastFrameUs   = spent;
+    rs->stats.p99FrameUs    = sorted[k];
+    rs->stats.totalServiced += serviced;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// Budgeted repath queue. Agents that need a new path enqueue a request instead of searching
+// on the spot; each frame Repath_Service runs searches in priority order until the
+// microsecond budget is used up and carries the rest over, so bursts of expiring repath
+// timers (e.g. a wave spawning at once) spread over several frames instead of spiking one.
+
+#define REPATH_FRAME_HISTORY 256
+
+struct RepathRequest {
+    int32_t agentId;
+    float   key;        // lower runs first (priority plus enqueue-time aging)
+};
+
+struct RepathStats {
+    uint32_t queueDepth      = 0;   // requests still waiting after the last service
+    uint32_t servicedLast    = 0;   // searches run by the last service
+    float    lastFrameUs     = 0.f; // time spent searching in the last service
+    float    p99FrameUs      = 0.f; // 99th percentile of the recent services
+    uint64_t totalServiced   = 0;
+};
+
+struct RepathScheduler {
+    float    budgetUs   = 1000.0f;  // per-frame search budget
+    float    agingPerFrame = 2.0f;  // key units a request gains per frame it has waited
+    uint32_t batchSize  = 1;        // requests handed to the callback at once
+    uint32_t frame      = 0;
+
+    std::vector<RepathRequest> heap;
+    std::vector<int32_t> batch;
+    float    history[REPATH_FRAME_HISTORY] = {};
+    uint32_t historyCount = 0;
+
+    RepathStats stats;
+};
+
+// Runs the searches for a batch of queued agents (possibly in parallel); returns how many
+// were serviced, skipping agents that no longer exist.
+typedef uint32_t (*RepathBatchFn)(const int32_t* agentIds, uint32_t count, void* user);
+
+void Repath_Clear(RepathScheduler* rs);
+
+// Queue a search for agentId. Lower priority values are served first. The caller makes sure
+// an agent is only queued once.
+void Repath_Enqueue(RepathScheduler* rs, int32_t agentId, float priority);
+
+// Runs queued searches in batches of batchSize until the budget is spent (always at least one
+// batch), then updates stats.
+void Repath_Service(RepathScheduler* rs, RepathBatchFn fn, void* user);
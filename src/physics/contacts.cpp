@@ -0,0 +1,74 @@
+#include "contacts.h"
+#include "physics.h"
+#include "../entity/enemies.hpp"
+#include "../player/projectile.h"
+#include "../state.h"
+#include <utility>
+
+ContactStats g_contactStats;
+
+static int32_t EntityOfShape(EntitySystem* es, b2ShapeId shape) {
+    return Entities_Index(es, Physics_EntityOf(b2Shape_GetBody(shape)));
+}
+
+static void OnPlayerEnemy() {
+    if (g_gameOver) return;
+    g_gameOver = true;
+    TraceLog(LOG_INFO, "💀 Player touched by enemy — GAME OVER!");
+}
+
+// Thrown elemental props hurt enemies and are used up
+static void OnPropEnemy(EntitySystem* es, int32_t prop, int32_t enemy) {
+    if (prop < 0 || !(es->flags[prop] & ENTITY_ACTIVE)) return;
+    if (es->kind[prop] == EntityKind::Enemy) return;
+
+    bool hit = false;
+    if (es->element[prop] == ElementType::FIRE)
+        hit = Enemies_Damage(es, enemy, 100.0f, 0.0f, "🔥 Enemy hit by telekinetic FIRE prop!");
+    else if (es->element[prop] == ElementType::ICE)
+        hit = Enemies_Damage(es, enemy, 90.0f, 3.0f, "❄️ Enemy hit by telekinetic ICE prop!");
+
+    if (hit) {
+        Physics_QueueDeletion(0, es->pos[prop], es->id[prop], es->kind[prop]);
+        es->flags[prop] &= ~ENTITY_ACTIVE;
+    }
+}
+
+static void Route(EntitySystem* es, b2ShapeId a, b2ShapeId b, bool begin) {
+    // A shape destroyed earlier in this pass (e.g. a projectile that already hit) drops out here
+    if (!b2Shape_IsValid(a) || !b2Shape_IsValid(b)) return;
+
+    uint64_t catA = b2Shape_GetFilter(a).categoryBits;
+    uint64_t catB = b2Shape_GetFilter(b).categoryBits;
+    if (catA > catB) {
+        std::swap(a, b);
+        std::swap(catA, catB);
+    }
+
+    if (catA == PlayerBit && catB == EnemyBit) {
+        g_contactStats.playerEnemy++;
+        OnPlayerEnemy();
+    } else if (catB == ProjectileBit && begin) {
+        g_contactStats.projectile++;
+        Projectile_OnContact(b2Shape_GetBody(b), EntityOfShape(es, a), es);
+    } else if (catA == DynamicBit && catB == EnemyBit && begin) {
+        g_contactStats.propEnemy++;
+        OnPropEnemy(es, EntityOfShape(es, a), EntityOfShape(es, b));
+    } else {
+        g_contactStats.ignored++;
+    }
+}
+
+void Contacts_Dispatch(b2WorldId world, EntitySystem* es) {
+    if (!es) return;
+
+    b2ContactEvents events = b2World_GetContactEvents(world);
+    g_contactStats.events += (uint64_t)(events.beginCount + events.hitCount);
+
+    for (int32_t i = 0; i < events.beginCount; ++i)
+        Route(es, events.beginEvents[i].shapeIdA, events.beginEvents[i].shapeIdB, true);
+
+    // Hit events only matter for the player (not enabled on any shape at the moment)
+    for (int32_t i = 0; i < events.hitCount; ++i)
+        Route(es, events.hitEvents[i].shapeIdA, events.hitEvents[i].shapeIdB, false);
+}
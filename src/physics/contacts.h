@@ -0,0 +1,24 @@
+#pragma once
+#include "../../lib/box2d/include/box2d/box2d.h"
+#include "../entity/entity.hpp"
+#include <cstdint>
+
+// One pass over the step's contact events. Each event is classified once by the two shapes'
+// category bits and routed to its handler:
+//   player     + enemy -> game over
+//   projectile + any   -> projectile effect (damage if enemy), projectile destroyed
+//   prop       + enemy -> elemental telekinetic prop hit
+// Everything else (walls, prop-prop, ...) is ignored.
+
+struct ContactStats {
+    uint64_t events;            // begin + hit events read
+    uint64_t playerEnemy;
+    uint64_t projectile;
+    uint64_t propEnemy;
+    uint64_t ignored;
+};
+
+extern ContactStats g_contactStats;
+
+// Call once per tick after b2World_Step
+void Contacts_Dispatch(b2WorldId world, EntitySystem* es);
@@ -3,14 +3,25 @@
 #include "raylib.h"
 #include "../level/level.h"
 #include "../entity/entity.hpp"
+#include "../memory/arena.h"
 #include <vector>
-#include <unordered_map>
 
-const float tick 	= 1.0f / 20.0f;
+const float tick 	= 1.0f / 20.0f;   // game seconds per fixed step
 const int subSteps 	= 4;
+// Game seconds per real second. The game used to step 1/20 s once per 60 Hz frame and all
+// speeds, cooldowns and impulses were tuned at that pace, so the fixed step keeps it:
+// 60 steps a second, each 1/20 s of game time.
+const float timeScale 	= 3.0f;
+
+// Entity <-> body links as flat arrays: one indexed load per lookup either way
+struct EntityBodyLinks {
+    std::vector<int>      idBySlot;       // by entity slot: id that owns the link, 0 if none
+    std::vector<b2BodyId> bodyBySlot;     // by entity slot
+    std::vector<int>      entityByBody;   // by b2BodyId::index1, 0 if none
+    uint32_t              count = 0;
+};
 
-extern std::unordered_map<int, b2BodyId> g_entityToBody;
-extern std::unordered_map<uint32_t, int> g_bodyToEntity;
+extern EntityBodyLinks g_bodyLinks;
 extern b2BodyId g_playerBody;
 
 // collision categories
@@ -19,7 +30,7 @@ enum CollisionBits : uint64_t {
     PlayerBit       = 0x0002,
     DynamicBit      = 0x0004,
     EnemyBit        = 0x0008,
-    ProjectileBit   = 0x0016,
+    ProjectileBit   = 0x0010,
     AllBits         = ~0ull
 };
 
@@ -30,7 +41,7 @@ struct Ent_To_Del {
     EntityKind kind;
 };
 
-static std::vector<Ent_To_Del> g_entDelQueue;
+extern ArenaVector<Ent_To_Del> g_entDelQueue;   // frame arena, flushed every tick
 
 // pixels -> meters (default: 1 tile == 1 meter)
 inline float PxToM(float px) { return px / (float)TILE_SIZE; }
@@ -38,20 +49,66 @@ inline float MToPx(float m)  { return m  * (float)TILE_SIZE; }
 inline Vector2 PxToM(Vector2 p){ return { PxToM(p.x), PxToM(p.y) }; }
 inline Vector2 MToPx(b2Vec2   p){ return { MToPx(p.x), MToPx(p.y) }; }
 
-// world lifecycle
+// world lifecycle; the world steps on g_jobs' workers, so create g_jobs first
 b2WorldId InitWorld();
 void DestroyWorld(b2WorldId worldId);
 
-void Physics_RegisterBody(Entity& e, b2BodyId body);
+void Physics_RegisterBody(int entityId, b2BodyId body);
 void Physics_UnregisterBody(int entityId);
+void Physics_ClearBodies();
+// Destroys every entity-linked body, then clears the links
+void Physics_DestroyEntityBodies();
+
+// b2_nullBodyId if the entity has no body (or the id is stale)
+inline b2BodyId Physics_BodyOf(int entityId) {
+    const uint32_t slot = EntityId_Slot(entityId);
+    if (slot >= g_bodyLinks.idBySlot.size() || g_bodyLinks.idBySlot[slot] != entityId)
+        return b2_nullBodyId;
+    return g_bodyLinks.bodyBySlot[slot];
+}
+
+// Entity id registered for a body, 0 if none
+inline int Physics_EntityOf(b2BodyId body) {
+    const uint32_t idx = (uint32_t)body.index1;
+    return idx < g_bodyLinks.entityByBody.size() ? g_bodyLinks.entityByBody[idx] : 0;
+}
 
 
 void Physics_QueueDeletion (size_t i, const Vector2& pos, int id, EntityKind kind);
 void Physics_FlushDeletions(b2WorldId world, EntitySystem* es);
 
-// build static colliders from tile grid (one box per wall tile)
+#define STATIC_CHUNK_SIZE 16   // tiles per side of a wall-collider chunk
+
+// build static colliders from tile grid: chained wall perimeters, one static body per chunk
 void BuildStaticsFromGrid(b2WorldId worldId, const Grid* g);
 
+// re-trace the wall colliders after tiles in [x, x+w) x [y, y+h) changed; only the chunks
+// touching the edit are rebuilt. Returns how many were.
+int  Physics_UpdateTiles(b2WorldId worldId, const Grid* g, int x, int y, int w, int h);
+
+// wall segments across every chunk body, for checking edits against a full rebuild
+int  Physics_StaticShapeCount();
+
+// Body + shape settings shared by every body of a kind in a batched spawn
+enum class BodyTemplate : uint8_t { Prop, Enemy, Corpse, Count };
+
+// count entries of parallel arrays; positions and half extents in pixels
+struct BodySpawnBatch {
+    const int*          entityIds;
+    const Vector2*      posPx;
+    const Vector2*      halfPx;
+    const BodyTemplate* templates;
+    int32_t             count;
+};
+
+// Creates a dynamic box body per entry and registers it with its entity. The defs are
+// built once per template and the link arrays sized once for the whole batch.
+void Physics_CreateBodies(b2WorldId worldId, const BodySpawnBatch* batch);
+// One batch for the active entities from dense index begin on (only *onlyKind ones if
+// given), all from one template
+void Physics_CreateEntityBodies(EntitySystem* es, b2WorldId worldId, int32_t begin,
+                                const EntityKind* onlyKind, BodyTemplate tmpl);
+
 void Create_Entity_Bodies(EntitySystem* es, b2WorldId worldId);
 void Entities_Update(EntitySystem* es, float dt);
 
@@ -62,6 +119,3 @@ b2BodyId CreatePlayer(b2WorldId worldId, Vector2 spawnPixels,
 
 // fetch player world position in pixels (center)
 Vector2 GetPlayerPixels(b2BodyId playerId);
-
-void Contact_ProcessPlayerEnemy(b2WorldId world, EntitySystem* es);
-
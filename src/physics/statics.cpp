@@ -0,0 +1,242 @@
+#include "physics.h"
+#include "../memory/arena.h"
+#include <cmath>
+#include <cstring>
+
+// Wall colliders, one static body per STATIC_CHUNK_SIZE^2 block of tiles.
+//
+// Each chunk traces the exposed sides of its own wall tiles, with exposure judged against
+// the whole grid, so nothing is emitted along chunk seams. Perimeters that stay inside a
+// chunk become chain loops. Perimeters that cross a seam become open chains that end on the
+// seam, with the neighbouring vertices as ghost vertices so bodies slide across the seam
+// without snagging.
+//
+// Directed edges run with the wall on the right (screen space, y down):
+// 0 = +x along a tile's top, 1 = +y along its right, 2 = -x along its bottom, 3 = -y along
+// its left. A directed edge is named by its start vertex and direction.
+
+struct StaticChunks {
+    b2WorldId             world = {};
+    int                   w = 0, h = 0;     // grid size the table was built for
+    int                   chunksX = 0, chunksY = 0;
+    std::vector<b2BodyId> bodies;           // b2_nullBodyId for chunks without walls
+};
+
+static StaticChunks g_statics;
+
+static const int kDX[4] = { 1, 0, -1, 0 };
+static const int kDY[4] = { 0, 1, 0, -1 };
+
+static bool IsWall(const Grid* g, int x, int y) {
+    if (x < 0 || y < 0 || x >= g->w || y >= g->h) return false;
+    return g->t[y * g->w + x].id == TILE_WALL;
+}
+
+// Wall tile the edge belongs to (its side index equals the direction)
+static void EdgeTile(int vx, int vy, int d, int* tx, int* ty) {
+    switch (d) {
+        case 0:  *tx = vx;     *ty = vy;     break;
+        case 1:  *tx = vx - 1; *ty = vy;     break;
+        case 2:  *tx = vx - 1; *ty = vy - 1; break;
+        default: *tx = vx;     *ty = vy - 1; break;
+    }
+}
+
+static bool EdgeExists(const Grid* g, int vx, int vy, int d) {
+    int tx, ty;
+    EdgeTile(vx, vy, d, &tx, &ty);
+    // The open side is one step to the left of the direction of travel
+    return IsWall(g, tx, ty) && !IsWall(g, tx + kDY[d], ty - kDX[d]);
+}
+
+// Direction the perimeter continues in after arriving at (vx,vy) heading `din`.
+// Turning right first keeps diagonally touching walls on separate perimeters.
+static int NextDir(const Grid* g, int vx, int vy, int din) {
+    const int order[3] = { (din + 1) & 3, din, (din + 3) & 3 };
+    for (int c : order)
+        if (EdgeExists(g, vx, vy, c)) return c;
+    return -1;
+}
+
+// Direction of the edge that leads into (vx,vy) and continues as `d`
+static int PrevDir(const Grid* g, int vx, int vy, int d) {
+    for (int din = 0; din < 4; ++din)
+        if (EdgeExists(g, vx - kDX[din], vy - kDY[din], din) && NextDir(g, vx, vy, din) == d)
+            return din;
+    return -1;
+}
+
+static b2Vec2 VertexToM(int vx, int vy) {
+    return (b2Vec2){ PxToM((float)vx * TILE_SIZE), PxToM((float)vy * TILE_SIZE) };
+}
+
+static bool Collinear(b2Vec2 a, b2Vec2 b, b2Vec2 c) {
+    if (fabsf(a.x - b.x) < 1e-6f && fabsf(b.x - c.x) < 1e-6f) return true; // vertical
+    if (fabsf(a.y - b.y) < 1e-6f && fabsf(b.y - c.y) < 1e-6f) return true; // horizontal
+    return false;
+}
+
+// Merges straight runs in place; the first and last points stay put
+static int MergeCollinear(b2Vec2* pts, int n) {
+    int m = 0;
+    for (int i = 0; i < n; ++i) {
+        if (m >= 2 && Collinear(pts[m-2], pts[m-1], pts[i])) pts[m-1] = pts[i];
+        else pts[m++] = pts[i];
+    }
+    return m;
+}
+
+static void AddChain(b2WorldId world, b2BodyId* body, const b2Vec2* pts, int count, bool loop) {
+    if (B2_IS_NULL(*body)) {
+        b2BodyDef bd = b2DefaultBodyDef();
+        *body = b2CreateBody(world, &bd);
+        b2Body_EnableContactEvents(*body, true);
+    }
+    b2ChainDef cd = b2DefaultChainDef();
+    cd.points = pts;
+    cd.count = count;
+    cd.isLoop = loop;
+    b2CreateChain(*body, &cd);
+}
+
+static void BuildChunk(b2WorldId world, const Grid* g, int cx, int cy, ArenaVector<b2Vec2>& pts) {
+    b2BodyId& body = g_statics.bodies[(size_t)cy * g_statics.chunksX + cx];
+    if (B2_IS_NON_NULL(body) && b2Body_IsValid(body)) b2DestroyBody(body);
+    body = b2_nullBodyId;
+
+    const int S  = STATIC_CHUNK_SIZE;
+    const int x0 = cx * S, y0 = cy * S;
+    const int x1 = x0 + S < g->w ? x0 + S : g->w;
+    const int y1 = y0 + S < g->h ? y0 + S : g->h;
+
+    auto inChunk = [&](int tx, int ty) { return tx >= x0 && ty >= y0 && tx < x1 && ty < y1; };
+
+    // Traced edges, per chunk tile and side
+    uint8_t used[STATIC_CHUNK_SIZE * STATIC_CHUNK_SIZE * 4];
+    memset(used, 0, sizeof(used));
+    auto usedAt = [&](int vx, int vy, int d) -> uint8_t& {
+        int tx, ty;
+        EdgeTile(vx, vy, d, &tx, &ty);
+        return used[((ty - y0) * S + (tx - x0)) * 4 + d];
+    };
+
+    // Pass 0 starts only at edges entered from outside the chunk, so every open run is traced
+    // from its first edge. What is left in pass 1 are loops wholly inside the chunk.
+    for (int pass = 0; pass < 2; ++pass)
+        for (int ty = y0; ty < y1; ++ty)
+            for (int tx = x0; tx < x1; ++tx)
+                for (int side = 0; side < 4; ++side) {
+                    // Start vertex of this side's edge
+                    const int sx = tx + (side == 1 || side == 2);
+                    const int sy = ty + (side == 2 || side == 3);
+                    if (!EdgeExists(g, sx, sy, side) || usedAt(sx, sy, side)) continue;
+
+                    pts.clear();
+                    bool open = false;
+                    if (pass == 0) {
+                        const int pd = PrevDir(g, sx, sy, side);
+                        if (pd < 0) continue;
+                        int ptx, pty;
+                        EdgeTile(sx - kDX[pd], sy - kDY[pd], pd, &ptx, &pty);
+                        if (inChunk(ptx, pty)) continue;
+                        pts.push_back(VertexToM(sx - kDX[pd], sy - kDY[pd]));  // ghost
+                        open = true;
+                    }
+
+                    int vx = sx, vy = sy, d = side;
+                    for (int safety = S * S * 4 + 1; safety > 0; --safety) {
+                        usedAt(vx, vy, d) = 1;
+                        pts.push_back(VertexToM(vx, vy));
+                        vx += kDX[d];
+                        vy += kDY[d];
+
+                        const int nd = NextDir(g, vx, vy, d);
+                        if (nd < 0) break; // graph error
+
+                        int ntx, nty;
+                        EdgeTile(vx, vy, nd, &ntx, &nty);
+                        if (!inChunk(ntx, nty)) {
+                            // Leaves the chunk: last real vertex, then the ghost beyond it
+                            pts.push_back(VertexToM(vx, vy));
+                            pts.push_back(VertexToM(vx + kDX[nd], vy + kDY[nd]));
+                            break;
+                        }
+                        if (vx == sx && vy == sy && nd == side) break; // closed the loop
+                        d = nd;
+                    }
+
+                    int m = (int)pts.size();
+                    if (open) {
+                        // Ghosts stay as traced, only the real run is merged
+                        if (m < 4) continue;
+                        int real = MergeCollinear(pts.data() + 1, m - 2);
+                        pts[(size_t)real + 1] = pts[(size_t)m - 1];
+                        AddChain(world, &body, pts.data(), real + 2, false);
+                    } else {
+                        if (m < 4) continue;
+                        m = MergeCollinear(pts.data(), m);
+                        if (m >= 3 && Collinear(pts[m-2], pts[m-1], pts[0])) m -= 1;
+                        if (m >= 3 && Collinear(pts[m-1], pts[0], pts[1])) {
+                            for (int i = 0; i < m-1; ++i) pts[i] = pts[i+1];
+                            m -= 1;
+                        }
+                        if (m >= 3) AddChain(world, &body, pts.data(), m, true);
+                    }
+                }
+}
+
+static void BuildChunks(b2WorldId world, const Grid* g, int cx0, int cy0, int cx1, int cy1) {
+    // Chain points are level scratch, handed back on return
+    const size_t mark = Arena_Mark(&g_levelArena);
+    {
+        ArenaVector<b2Vec2> pts{ ArenaAllocator<b2Vec2>(&g_levelArena) };
+        pts.reserve(STATIC_CHUNK_SIZE * STATIC_CHUNK_SIZE * 4 + 2);
+        for (int cy = cy0; cy <= cy1; ++cy)
+            for (int cx = cx0; cx <= cx1; ++cx)
+                BuildChunk(world, g, cx, cy, pts);
+    }
+    Arena_Rewind(&g_levelArena, mark);
+}
+
+void BuildStaticsFromGrid(b2WorldId worldId, const Grid* g) {
+    if (!g || g->w <= 0 || g->h <= 0) return;
+
+    // Bodies from a previous world went with it
+    g_statics.world   = worldId;
+    g_statics.w       = g->w;
+    g_statics.h       = g->h;
+    g_statics.chunksX = (g->w + STATIC_CHUNK_SIZE - 1) / STATIC_CHUNK_SIZE;
+    g_statics.chunksY = (g->h + STATIC_CHUNK_SIZE - 1) / STATIC_CHUNK_SIZE;
+    g_statics.bodies.assign((size_t)g_statics.chunksX * g_statics.chunksY, b2_nullBodyId);
+
+    BuildChunks(worldId, g, 0, 0, g_statics.chunksX - 1, g_statics.chunksY - 1);
+}
+
+int Physics_UpdateTiles(b2WorldId worldId, const Grid* g, int x, int y, int w, int h) {
+    if (!g || w <= 0 || h <= 0) return 0;
+    if (g_statics.w != g->w || g_statics.h != g->h ||
+        g_statics.world.index1 != worldId.index1 || g_statics.world.generation != worldId.generation) {
+        BuildStaticsFromGrid(worldId, g);
+        return g_statics.chunksX * g_statics.chunksY;
+    }
+
+    // A tile decides the exposure of its neighbours' sides, and a seam chain's ghost vertex
+    // sits one edge past the seam, so chunks within two tiles of the edit are dirty too
+    const int S = STATIC_CHUNK_SIZE;
+    int tx0 = x - 2, ty0 = y - 2, tx1 = x + w + 1, ty1 = y + h + 1;
+    if (tx0 < 0) tx0 = 0;
+    if (ty0 < 0) ty0 = 0;
+    if (tx1 > g->w - 1) tx1 = g->w - 1;
+    if (ty1 > g->h - 1) ty1 = g->h - 1;
+    if (tx0 > tx1 || ty0 > ty1) return 0;
+
+    BuildChunks(worldId, g, tx0 / S, ty0 / S, tx1 / S, ty1 / S);
+    return (tx1 / S - tx0 / S + 1) * (ty1 / S - ty0 / S + 1);
+}
+
+int Physics_StaticShapeCount() {
+    int count = 0;
+    for (b2BodyId body : g_statics.bodies)
+        if (B2_IS_NON_NULL(body) && b2Body_IsValid(body)) count += b2Body_GetShapeCount(body);
+    return count;
+}
@@ -2,27 +2,15 @@
 #include "../level/level.h"
 #include "../physics/physics.h"
 #include "../anims/animations.hpp"
+#include "../anims/sprites.hpp"
 #include "projectile.h"
+#include "../memory/arena.h"
 #include <math.h>
 #include <raylib.h>
 #include "raymath.h"
 #include <time.h>
 #include <vector>
 
-static bool HasSpaceAround(const Grid* g, int x, int y, int radius) {
-    for (int dy = -radius; dy <= radius; ++dy) {
-        for (int dx = -radius; dx <= radius; ++dx) {
-            int nx = x + dx;
-            int ny = y + dy;
-            Tile* t = grid_at((Grid*)g, nx, ny);
-            if (!t || t->id != TILE_FLOOR) {
-                return false; // any wall or out-of-bounds fails
-            }
-        }
-    }
-    return true;
-}
-
 static Vector2 FindFloorSpawn(const Grid* g) {
     // fallback center if nothing suitable
     Vector2 fallback = { (float)(g->w * TILE_SIZE / 2), (float)(g->h * TILE_SIZE / 2) };
@@ -30,26 +18,30 @@ static Vector2 FindFloorSpawn(const Grid* g) {
     // collect all floor candidates
     int capacity = g->w * g->h;
     int count = 0;
-    int* candidates = (int*)malloc(sizeof(int) * capacity);
+    const size_t mark = Arena_Mark(&g_levelArena);
+    int* candidates = Arena_AllocArray<int>(&g_levelArena, (size_t)capacity);
+    uint64_t* clear = Arena_AllocArray<uint64_t>(&g_levelArena, (size_t)g->walkStride);
+    if (!candidates || !clear) {
+        Arena_Rewind(&g_levelArena, mark);
+        return fallback;
+    }
 
+    // Floor tiles with 3 tiles of floor all around, a row of walkability words at a time
     for (int y = 0; y < g->h; ++y) {
-        for (int x = 0; x < g->w; ++x) {
-            Tile* t = grid_at((Grid*)g, x, y);
-            if (t && t->id == TILE_FLOOR && HasSpaceAround(g, x, y, 3)) {
-                candidates[count++] = y * g->w + x;
-            }
-        }
+        grid_walk_clearance_row(g, y, 3, clear);
+        for (int j = 0; j < g->walkStride; ++j)
+            for (uint64_t bits = clear[j]; bits; bits &= bits - 1)
+                candidates[count++] = y * g->w + walk_bit_x(j, walk_ctz(bits));
     }
 
     if (count == 0) {
-        free(candidates);
+        Arena_Rewind(&g_levelArena, mark);
         return fallback;
     }
 
-    // pick random from valid rooms
-    srand((unsigned int)time(NULL));
-    int pick = candidates[rand() % count];
-    free(candidates);
+    // pick random from valid rooms (raylib RNG, so a seeded run is reproducible)
+    int pick = candidates[GetRandomValue(0, count - 1)];
+    Arena_Rewind(&g_levelArena, mark);
 
     int px = pick % g->w;
     int py = pick / g->w;
@@ -70,6 +62,7 @@ static inline float damp(float current, float target, float lambda, float dt) {
 
 void Player_Init(Player* p, const Grid* level) {
     p->pos   = FindFloorSpawn(level);
+    p->prevPos = p->pos;
     p->vel   = (Vector2){ 0, 0 };
     p->halfw = 12.0f;
     p->halfh = 12.0f;
@@ -77,8 +70,8 @@ void Player_Init(Player* p, const Grid* level) {
 
     // Setup animations
     p->facingRight = true;
-    p->idleAnim = Animation_Load("../../assets/player/player_idle.png", 4, 0.5f);
-    p->runAnim  = Animation_Load("../../assets/player/player_run.png", 4, 0.25f);
+    p->idleAnim = Animation_Load(SPRITE_PLAYER_IDLE, 4, 0.5f);
+    p->runAnim  = Animation_Load(SPRITE_PLAYER_RUN, 4, 0.25f);
  
     p->currentAnim = &p->idleAnim;
 
@@ -101,22 +94,26 @@ Vector2 Build_Input() {
     return dir;
 }
 
+// Candidates for telekinesis, reused across calls
+static std::vector<int32_t> s_nearby;
+
 // Apply a force at the center of each entity within a radius of `pos`
 
 void Telekinesis_Hold(Vector2 pos, float orbitRadius, Vector2 force, EntitySystem* es)
 {
     if (!es) return;
 
-    for (Entity& e : es->pool)
+    // Entity positions match the bodies here (synced at the end of the last tick)
+    s_nearby.clear();
+    Entities_QueryRadius(es, pos, orbitRadius * 2.0f, &s_nearby);
+
+    for (int32_t e : s_nearby)
     {
-        if (!e.active) continue;
-        if (e.kind == EntityKind::Enemy) continue;
+        if (es->kind[e] == EntityKind::Enemy) continue;
 
         // Look up body by entity ID
-        auto it = g_entityToBody.find(e.id);
-        if (it == g_entityToBody.end()) continue;
-        b2BodyId body = it->second;
-        if (!b2Body_IsValid(body)) continue;
+        b2BodyId body = Physics_BodyOf(es->id[e]);
+        if (B2_IS_NULL(body) || !b2Body_IsValid(body)) continue;
 
         // Compute position and distance from player
         b2Vec2 bpos = b2Body_GetPosition(body);
@@ -127,15 +124,15 @@ void Telekinesis_Hold(Vector2 pos, float orbitRadius, Vector2 force, EntitySyste
         if (dist < 2.0f || dist > orbitRadius * 2.0f) continue;
 
         // Assign element + color when first grabbed
-        if (!e.telekinetic)
+        if (!(es->flags[e] & ENTITY_TELEKINETIC))
         {
-            e.telekinetic = true;
+            es->flags[e] |= ENTITY_TELEKINETIC;
             if (g_currentProjectile == ProjectileType::FIRE) {
-                e.element = ElementType::FIRE;
-                e.color   = (Color){255, 80, 20, 255};
+                es->element[e] = ElementType::FIRE;
+                es->color[e]   = (Color){255, 80, 20, 255};
             } else {
-                e.element = ElementType::ICE;
-                e.color   = (Color){100, 180, 255, 255};
+                es->element[e] = ElementType::ICE;
+                es->color[e]   = (Color){100, 180, 255, 255};
             }
         }
 
@@ -164,17 +161,17 @@ void Telekinesis_Fire(Vector2 playerPos, float orbitRadius, float launchForce, E
 {
     if (!es) return;
 
-    for (Entity& e : es->pool)
+    s_nearby.clear();
+    Entities_QueryRadius(es, playerPos, orbitRadius * 1.5f, &s_nearby);
+
+    for (int32_t e : s_nearby)
     {
-        if (!e.active) continue;
-        if (e.kind == EntityKind::Enemy) continue;
-        if (!e.telekinetic) continue; // only fire held props
+        if (es->kind[e] == EntityKind::Enemy) continue;
+        if (!(es->flags[e] & ENTITY_TELEKINETIC)) continue; // only fire held props
 
         // Look up body by entity ID
-        auto it = g_entityToBody.find(e.id);
-        if (it == g_entityToBody.end()) continue;
-        b2BodyId body = it->second;
-        if (!b2Body_IsValid(body)) continue;
+        b2BodyId body = Physics_BodyOf(es->id[e]);
+        if (B2_IS_NULL(body) || !b2Body_IsValid(body)) continue;
 
         b2Vec2 bpos = b2Body_GetPosition(body);
         Vector2 bodyPosPx = { MToPx(bpos.x), MToPx(bpos.y) };
@@ -194,10 +191,10 @@ void Telekinesis_Fire(Vector2 playerPos, float orbitRadius, float launchForce, E
         b2Body_ApplyTorque(body, torque, true);
 
         TraceLog(LOG_INFO, "Telekinesis fired prop (Entity %d, %s)",
-                 e.id, (e.element == ElementType::FIRE ? "FIRE" : "ICE"));
+                 es->id[e], (es->element[e] == ElementType::FIRE ? "FIRE" : "ICE"));
 
         // Mark it released
-        e.telekinetic = false;
+        es->flags[e] &= ~ENTITY_TELEKINETIC;
     }
 }
 
@@ -205,6 +202,13 @@ void Telekinesis_Fire(Vector2 playerPos, float orbitRadius, float launchForce, E
 
 void UpdatePlayer(Player* p, b2BodyId playerId, float dt, Vector2 inputDir, float speedPixelsPerSec)
 {
+    // Facing follows the horizontal input, not the velocity
+    if (inputDir.x > 0.0f) {
+        p->facingRight = true;
+    } else if (inputDir.x < 0.0f) {
+        p->facingRight = false;
+    }
+
     // Normalize input
     float len = sqrtf(inputDir.x * inputDir.x + inputDir.y * inputDir.y);
     if (len > 0.0001f) {
@@ -223,14 +227,6 @@ void UpdatePlayer(Player* p, b2BodyId playerId, float dt, Vector2 inputDir, floa
     b2Vec2 posM = b2Body_GetPosition(playerId);
     p->pos = { MToPx(posM.x), MToPx(posM.y) };
 
-    // --- Handle facing once ---
-    // Use actual *key state*, not velocity, and only flip if user changes it
-    if (IsKeyDown(KEY_D)) {
-        p->facingRight = true;
-    } else if (IsKeyDown(KEY_A)) {
-        p->facingRight = false;
-    }
-
     // --- Choose animation ---
     bool isMoving = fabsf(vel.x) > 0.01f || fabsf(vel.y) > 0.01f;
     p->currentAnim = isMoving ? &p->runAnim : &p->idleAnim;
@@ -244,10 +240,15 @@ void UpdatePlayer(Player* p, b2BodyId playerId, float dt, Vector2 inputDir, floa
     Animation_Update(p->currentAnim, dt);
 }
 
-void Player_Draw(const Player* p)
+Vector2 Player_RenderPos(const Player* p, float alpha)
+{
+    return Vector2Lerp(p->prevPos, p->pos, alpha);
+}
+
+void Player_Draw(const Player* p, float alpha)
 {
     if (!p->currentAnim) return;
-    Animation_Draw(p->currentAnim, p->pos, 1.0f, WHITE);
+    Animation_Draw(p->currentAnim, Player_RenderPos(p, alpha), 1.0f, WHITE);
 }
 
 void Player_Unload(Player* p) {
@@ -7,6 +7,7 @@
 
 typedef struct {
     Vector2 pos;      // center position in pixels
+    Vector2 prevPos;  // pos at the start of the current tick, for interpolation
     Vector2 vel;      // per-frame velocity in pixels
     float   halfw;
     float   halfh;
@@ -30,6 +31,8 @@ void Telekinesis_Fire(Vector2 playerPos, float orbitRadius, float launchForce, E
 void Player_Init(Player* p, const Grid* level);
 Vector2 Build_Input();
 void UpdatePlayer(Player* p, b2BodyId playerId, float dt, Vector2 inputDir, float speedPxPerSec);
-void Player_Draw(const Player* p);
+// alpha in [0,1] blends from prevPos (0) to pos (1)
+Vector2 Player_RenderPos(const Player* p, float alpha);
+void Player_Draw(const Player* p, float alpha);
 void Player_Unload(Player* p);
 
@@ -9,152 +9,157 @@
 // GLOBAL STATE
 std::vector<Projectile> g_projectiles;
 ProjectileType g_currentProjectile = ProjectileType::FIRE;
-
-// PROJECTILE LOGIC
-void Projectile_HandleSwitch()
-{
-    if (IsKeyPressed(KEY_Q)) g_currentProjectile = ProjectileType::FIRE;
-    if (IsKeyPressed(KEY_E)) g_currentProjectile = ProjectileType::ICE;
+ProjectilePoolStats g_projectilePoolStats;
+
+// POOL
+// Slots never move: a fired projectile takes a free slot and enables its body, a spent one
+// disables the body and returns the slot. Bodies are only created when the pool grows.
+static std::vector<int32_t> g_projectileFree;   // free slots, popped from the back
+static b2WorldId g_projectileWorld = b2_nullWorldId;
+static int32_t g_projectileLive = 0;
+
+// g_projectiles index by b2BodyId::index1, -1 if none. Checked against the stored body on
+// lookup, so entries left behind by a destroyed world or a recycled index never match.
+static std::vector<int32_t> g_projectileByBody;
+
+static Projectile* ProjectileFromBody(b2BodyId body) {
+    const uint32_t idx = (uint32_t)body.index1;
+    if (idx >= g_projectileByBody.size()) return nullptr;
+    const int32_t k = g_projectileByBody[idx];
+    if (k < 0 || k >= (int32_t)g_projectiles.size()) return nullptr;
+    Projectile& p = g_projectiles[k];
+    const bool same = p.body.index1 == body.index1 && p.body.world0 == body.world0 &&
+                      p.body.generation == body.generation;
+    return same ? &p : nullptr;
 }
 
-void Projectile_Shoot(b2WorldId world, Vector2 playerPos, Camera2D cam)
-{
-    if (IsMouseButtonDown(MOUSE_BUTTON_LEFT)) {
-
-        Vector2 mouseWorld = GetScreenToWorld2D(GetMousePosition(), cam);
-        Vector2 dir = Vector2Normalize(Vector2Subtract(mouseWorld, playerPos));
-        Vector2 spawnPos = Vector2Add(playerPos, Vector2Scale(dir, 16.0f));
-
-        b2BodyDef bd = b2DefaultBodyDef();
-        bd.type = b2_dynamicBody;
-        bd.position = { PxToM(spawnPos.x), PxToM(spawnPos.y) };
-        bd.isBullet = true;
-        b2BodyId body = b2CreateBody(world, &bd);
-
-        b2Body_EnableContactEvents(body, true);
-
-        b2ShapeDef sd = b2DefaultShapeDef();
-        sd.density = 0.5f;
-        sd.filter.categoryBits = ProjectileBit;
-        sd.filter.maskBits = AllBits & ~ProjectileBit;
-
-        float radius = PxToM(4.0f);
-        b2Circle circle = { {0,0}, radius };
-        b2CreateCircleShape(body, &sd, &circle);
-
-        float impulseStrength = 5.0f;
-        b2Vec2 impulse = { PxToM(dir.x * impulseStrength), PxToM(dir.y * impulseStrength) };
-        b2Body_ApplyLinearImpulseToCenter(body, impulse, true);
-
-        Color color = (g_currentProjectile == ProjectileType::FIRE)
-            ? (Color){255, 80, 20, 255}
-            : (Color){100, 180, 255, 255};
-
-        g_projectiles.push_back({ g_currentProjectile, body, color, 3.0f, true });
-    }
+// New disabled bullet body in a new free slot
+static void GrowPool(b2WorldId world) {
+    b2BodyDef bd = b2DefaultBodyDef();
+    bd.type = b2_dynamicBody;
+    bd.isBullet = true;
+    bd.isEnabled = false;
+    b2BodyId body = b2CreateBody(world, &bd);
+
+    b2Body_EnableContactEvents(body, true);
+
+    b2ShapeDef sd = b2DefaultShapeDef();
+    sd.density = 0.5f;
+    sd.filter.categoryBits = ProjectileBit;
+    // Projectiles pass through the player, props and each other
+    sd.filter.maskBits = AllBits & ~(ProjectileBit | PlayerBit | DynamicBit);
+
+    float radius = PxToM(4.0f);
+    b2Circle circle = { {0,0}, radius };
+    b2CreateCircleShape(body, &sd, &circle);
+
+    const int32_t k = (int32_t)g_projectiles.size();
+    g_projectiles.push_back({ ProjectileType::FIRE, body, {0,0}, {0,0}, BLANK, 0.0f, false });
+    g_projectileFree.push_back(k);
+
+    const uint32_t idx = (uint32_t)body.index1;
+    if (idx >= g_projectileByBody.size()) g_projectileByBody.resize((size_t)idx + 1, -1);
+    g_projectileByBody[idx] = k;
+    g_projectilePoolStats.created++;
 }
 
-// PROCESS CONTACT EVENTS FROM BOX2D
+static void ReleaseProjectile(Projectile& p) {
+    if (b2Body_IsValid(p.body)) b2Body_Disable(p.body);
+    p.active = false;
+    g_projectileFree.push_back((int32_t)(&p - g_projectiles.data()));
+    g_projectileLive--;
+}
 
-void Projectile_ProcessContacts(b2WorldId world, EntitySystem* es)
+void Projectile_InitPool(b2WorldId world, int32_t count)
 {
-    if (!es) return;
-
-    b2ContactEvents events = b2World_GetContactEvents(world);
-    if (events.beginCount == 0 && events.hitCount == 0 && events.endCount == 0)
-        return;
-
-    TraceLog(LOG_INFO, "Projectile contacts: begin=%d hit=%d end=%d",
-             events.beginCount, events.hitCount, events.endCount);
-
-    auto entityFromBody = [&](b2BodyId body) -> Entity* {
-        auto it = g_bodyToEntity.find(body.index1);
-        if (it == g_bodyToEntity.end()) return nullptr;
-        return Entities_Get(es, it->second);
-    };
-
-    auto damageEnemyFromEntity = [&](Entity* e, float dmg, float slowSec, const char* tag)
-    {
-        if (!e || !e->active || e->kind != EntityKind::Enemy) return false;
-        if (Enemy* en = Enemy_FromEntityId(e->id)) {
-            en->health -= dmg;
-            if (slowSec > 0.0f) en->slowTimer = slowSec;
-            TraceLog(LOG_INFO, "%s Enemy %d (HP=%.1f)", tag, e->id, en->health);
-            return true;
-        }
-        return false;
-    };
+    Projectile_Clear();
+    g_projectileWorld = world;
+    g_projectiles.reserve((size_t)count);
+    g_projectileFree.reserve((size_t)count);
+    for (int32_t i = 0; i < count; ++i) GrowPool(world);
+    // Pop the lowest slots first
+    std::reverse(g_projectileFree.begin(), g_projectileFree.end());
+}
 
-    // --- Handle begin contacts (enough for our gameplay)
-    for (int32_t i = 0; i < events.beginCount; ++i)
-    {
-        const b2ContactBeginTouchEvent* ev = &events.beginEvents[i];
-        if (!b2Shape_IsValid(ev->shapeIdA) || !b2Shape_IsValid(ev->shapeIdB)) continue;
+void Projectile_Clear()
+{
+    // The bodies go with their world; only the handles are dropped here
+    g_projectiles.clear();
+    g_projectileFree.clear();
+    g_projectileByBody.clear();
+    g_projectileWorld = b2_nullWorldId;
+    g_projectileLive = 0;
+}
 
-        b2BodyId bodyA = b2Shape_GetBody(ev->shapeIdA);
-        b2BodyId bodyB = b2Shape_GetBody(ev->shapeIdB);
-        if (!b2Body_IsValid(bodyA) || !b2Body_IsValid(bodyB)) continue;
+void Projectile_ReleaseAll()
+{
+    for (Projectile& p : g_projectiles)
+        if (p.active) ReleaseProjectile(p);
+}
 
-        Entity* entA = entityFromBody(bodyA);
-        Entity* entB = entityFromBody(bodyB);
+int32_t Projectile_LiveCount()
+{
+    return g_projectileLive;
+}
 
-        for (auto& p : g_projectiles)
-        {
-            if (!p.active || !b2Body_IsValid(p.body)) continue;
-            if (p.body.index1 != bodyA.index1 && p.body.index1 != bodyB.index1) continue;
-
-            // Apply projectile effects
-            bool hit = false;
-            if (p.type == ProjectileType::FIRE) {
-                // 50 dmg, no slow
-                hit |= damageEnemyFromEntity(entA, 50.0f, 0.0f, "🔥 Enemy hit by FIRE projectile");
-                hit |= damageEnemyFromEntity(entB, 50.0f, 0.0f, "🔥 Enemy hit by FIRE projectile");
-            } else if (p.type == ProjectileType::ICE) {
-                // 25 dmg + 2s slow
-                hit |= damageEnemyFromEntity(entA, 25.0f, 2.0f, "❄️ Enemy hit by ICE projectile");
-                hit |= damageEnemyFromEntity(entB, 25.0f, 2.0f, "❄️ Enemy hit by ICE projectile");
-            }
-
-            // Destroy projectile either way after a contact
-            if (b2Body_IsValid(p.body)) b2DestroyBody(p.body);
-            p.active = false;
-
-            if (hit) break; // done with this contact for this projectile
-        }
+// PROJECTILE LOGIC
+// Fires one projectile of the current type toward aimWorld
+void Projectile_Shoot(b2WorldId world, Vector2 playerPos, Vector2 aimWorld)
+{
+    if (world.index1 != g_projectileWorld.index1 || world.generation != g_projectileWorld.generation)
+        Projectile_InitPool(world, 0);
+    if (g_projectileFree.empty()) GrowPool(world);
+
+    Vector2 dir = Vector2Normalize(Vector2Subtract(aimWorld, playerPos));
+    Vector2 spawnPos = Vector2Add(playerPos, Vector2Scale(dir, 16.0f));
+
+    const int32_t k = g_projectileFree.back();
+    g_projectileFree.pop_back();
+    Projectile& p = g_projectiles[k];
+
+    // Move while disabled so no contacts are made at the old spot, then enable; a body only
+    // gets velocity state once it's enabled
+    b2Body_SetTransform(p.body, { PxToM(spawnPos.x), PxToM(spawnPos.y) }, b2Rot_identity);
+    b2Body_Enable(p.body);
+    b2Body_SetLinearVelocity(p.body, { 0.0f, 0.0f });
+    b2Body_SetAngularVelocity(p.body, 0.0f);
+
+    float impulseStrength = 5.0f;
+    b2Vec2 impulse = { PxToM(dir.x * impulseStrength), PxToM(dir.y * impulseStrength) };
+    b2Body_ApplyLinearImpulseToCenter(p.body, impulse, true);
+
+    Color color = (g_currentProjectile == ProjectileType::FIRE)
+        ? (Color){255, 80, 20, 255}
+        : (Color){100, 180, 255, 255};
+
+    p = { g_currentProjectile, p.body, spawnPos, spawnPos, color, 3.0f, true };
+    g_projectileLive++;
+    g_projectilePoolStats.fired++;
+    g_projectilePoolStats.peakLive = std::max(g_projectilePoolStats.peakLive, g_projectileLive);
+}
 
-        auto applyPropHit = [&](Entity* propEnt, Entity* otherEnt)
-        {
-            if (!propEnt || !propEnt->active) return;
-            if (propEnt->kind == EntityKind::Enemy) return;
-            if (propEnt->element == ElementType::NONE) return;
-
-            if (!otherEnt || !otherEnt->active || otherEnt->kind != EntityKind::Enemy) return;
-
-            if (propEnt->element == ElementType::FIRE) {
-                if (damageEnemyFromEntity(otherEnt, 100.0f, 0.0f, "🔥 Enemy hit by telekinetic FIRE prop!")) {
-                    // destroy the prop entity
-                    Physics_QueueDeletion(0, propEnt->pos, propEnt->id, propEnt->kind);
-                    propEnt->active = false;
-                }
-            } else if (propEnt->element == ElementType::ICE) {
-                if (damageEnemyFromEntity(otherEnt, 90.0f, 3.0f, "❄️ Enemy hit by telekinetic ICE prop!")) {
-                    Physics_QueueDeletion(0, propEnt->pos, propEnt->id, propEnt->kind);
-                    propEnt->active = false;
-                }
-            }
-        };
-
-        // Check both directions: prop(A) -> enemy(B), prop(B) -> enemy(A)
-        applyPropHit(entA, entB);
-        applyPropHit(entB, entA);
+// CONTACTS (routed here by Contacts_Dispatch)
+void Projectile_OnContact(b2BodyId body, int32_t otherEnt, EntitySystem* es)
+{
+    Projectile* p = ProjectileFromBody(body);
+    if (!p || !p->active) return;
+
+    // Apply projectile effects
+    if (p->type == ProjectileType::FIRE) {
+        // 50 dmg, no slow
+        Enemies_Damage(es, otherEnt, 50.0f, 0.0f, "🔥 Enemy hit by FIRE projectile");
+    } else if (p->type == ProjectileType::ICE) {
+        // 25 dmg + 2s slow
+        Enemies_Damage(es, otherEnt, 25.0f, 2.0f, "❄️ Enemy hit by ICE projectile");
     }
+
+    // Spent either way after a contact
+    ReleaseProjectile(*p);
 }
 
 // UPDATE + DRAW
-void Projectile_Update(b2WorldId world, EntitySystem *es, float dt)
+void Projectile_Update(float dt)
 {
-    Projectile_ProcessContacts(world, es);
-
     for (auto& p : g_projectiles)
     {
         if (!p.active) continue;
@@ -162,27 +167,21 @@ void Projectile_Update(b2WorldId world, EntitySystem *es, float dt)
         p.lifetime -= dt;
         if (p.lifetime <= 0.0f)
         {
-            if (b2Body_IsValid(p.body))
-                b2DestroyBody(p.body);
-            p.active = false;
+            ReleaseProjectile(p);
             continue;
         }
-    }
 
-    g_projectiles.erase(
-        std::remove_if(g_projectiles.begin(), g_projectiles.end(),
-                       [](const Projectile& p){ return !p.active; }),
-        g_projectiles.end()
-    );
+        p.prevPos = p.pos;
+        p.pos = MToPx(b2Body_GetPosition(p.body));
+    }
 }
 
-void Projectile_Draw()
+void Projectile_Draw(const int32_t* indices, int32_t count, float alpha)
 {
-    for (const auto& p : g_projectiles)
+    for (int32_t k = 0; k < count; ++k)
     {
+        const Projectile& p = g_projectiles[(size_t)indices[k]];
         if (!p.active) continue;
-        b2Vec2 pos = b2Body_GetPosition(p.body);
-        Vector2 posPx = { MToPx(pos.x), MToPx(pos.y) };
-        DrawCircleV(posPx, 4.0f, p.color);
+        DrawCircleV(Vector2Lerp(p.prevPos, p.pos, alpha), 4.0f, p.color);
     }
 }
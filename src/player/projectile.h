@@ -11,15 +11,39 @@ extern ProjectileType g_currentProjectile;
 struct Projectile {
     ProjectileType type;
     b2BodyId body;
+    Vector2 prevPos;    // pixels, at the start of the last tick
+    Vector2 pos;        // pixels, after the last tick
     Color color;
     float lifetime;
     bool active;
 };
 
+// Pool slots; only entries with active set are in flight
 extern std::vector<Projectile> g_projectiles;
 extern ProjectileType g_currentProjectile;
 
-void Projectile_HandleSwitch();
-void Projectile_Shoot(b2WorldId world, Vector2 playerPos, Camera2D cam);
-void Projectile_Update(b2WorldId world, EntitySystem *es, float dt);
-void Projectile_Draw();
+// Bodies created up front for each world
+#define PROJECTILE_POOL_INITIAL 128
+
+struct ProjectilePoolStats {
+    uint64_t fired;
+    uint64_t created;       // bodies created, up front or when the pool ran dry
+    int32_t  peakLive;
+};
+
+extern ProjectilePoolStats g_projectilePoolStats;
+
+// Creates count disabled projectile bodies in world, dropping any previous pool
+void Projectile_InitPool(b2WorldId world, int32_t count);
+// Drops the pool; call when its world is destroyed
+void Projectile_Clear();
+// Returns every live projectile to the pool (the bodies stay, disabled)
+void Projectile_ReleaseAll();
+int32_t Projectile_LiveCount();
+
+void Projectile_Shoot(b2WorldId world, Vector2 playerPos, Vector2 aimWorld);
+void Projectile_Update(float dt);
+// A begin contact on a projectile body; otherEnt is the other body's dense entity index or -1
+void Projectile_OnContact(b2BodyId body, int32_t otherEnt, EntitySystem* es);
+// Draws the given g_projectiles entries (usually the visible set)
+void Projectile_Draw(const int32_t* indices, int32_t count, float alpha);
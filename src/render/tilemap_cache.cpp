@@ -0,0 +1,158 @@
+#include "tilemap_cache.h"
+
+static const Color kWallColor  = (Color){ 60, 60, 70, 255 };
+static const Color kFloorColor = (Color){ 200, 200, 200, 255 };
+
+static Color TileColor(const Tile* t) {
+    return t->id == TILE_WALL ? kWallColor : kFloorColor;
+}
+
+void TilemapCache_Init(TilemapCache* tc, const Grid* g, int maxResident) {
+    TilemapCache_Free(tc);
+    tc->grid        = g;
+    tc->chunksX     = (g->w + TILEMAP_CHUNK_SIZE - 1) / TILEMAP_CHUNK_SIZE;
+    tc->chunksY     = (g->h + TILEMAP_CHUNK_SIZE - 1) / TILEMAP_CHUNK_SIZE;
+    tc->maxResident = maxResident > 0 ? maxResident : 1;
+    tc->chunks.assign((size_t)tc->chunksX * tc->chunksY, TilemapChunk{});
+}
+
+void TilemapCache_Free(TilemapCache* tc) {
+    for (TilemapChunk& c : tc->chunks)
+        if (c.resident) UnloadRenderTexture(c.rt);
+    tc->chunks.clear();
+    tc->chunksX = tc->chunksY = 0;
+    tc->stats.resident = 0;
+}
+
+void TilemapCache_Invalidate(TilemapCache* tc, int x, int y, int w, int h) {
+    if (!tc->grid || w <= 0 || h <= 0) return;
+    const int S = TILEMAP_CHUNK_SIZE;
+    int cx0 = x / S, cy0 = y / S;
+    int cx1 = (x + w - 1) / S, cy1 = (y + h - 1) / S;
+    if (cx0 < 0) cx0 = 0;
+    if (cy0 < 0) cy0 = 0;
+    if (cx1 >= tc->chunksX) cx1 = tc->chunksX - 1;
+    if (cy1 >= tc->chunksY) cy1 = tc->chunksY - 1;
+    for (int cy = cy0; cy <= cy1; ++cy)
+        for (int cx = cx0; cx <= cx1; ++cx)
+            tc->chunks[(size_t)cy * tc->chunksX + cx].dirty = true;
+}
+
+// Chunk range covered by the camera view (any rotation)
+static bool VisibleChunks(const TilemapCache* tc, Camera2D cam, int screenW, int screenH,
+                          int* cx0, int* cy0, int* cx1, int* cy1) {
+    const Vector2 corners[4] = {
+        GetScreenToWorld2D((Vector2){ 0, 0 }, cam),
+        GetScreenToWorld2D((Vector2){ (float)screenW, 0 }, cam),
+        GetScreenToWorld2D((Vector2){ 0, (float)screenH }, cam),
+        GetScreenToWorld2D((Vector2){ (float)screenW, (float)screenH }, cam),
+    };
+    Vector2 mn = corners[0], mx = corners[0];
+    for (int i = 1; i < 4; ++i) {
+        if (corners[i].x < mn.x) mn.x = corners[i].x;
+        if (corners[i].y < mn.y) mn.y = corners[i].y;
+        if (corners[i].x > mx.x) mx.x = corners[i].x;
+        if (corners[i].y > mx.y) mx.y = corners[i].y;
+    }
+
+    const float chunkPx = (float)(TILEMAP_CHUNK_SIZE * TILE_SIZE);
+    *cx0 = (int)(mn.x / chunkPx);
+    *cy0 = (int)(mn.y / chunkPx);
+    *cx1 = (int)(mx.x / chunkPx);
+    *cy1 = (int)(mx.y / chunkPx);
+    if (mx.x < 0.0f || mx.y < 0.0f || *cx0 >= tc->chunksX || *cy0 >= tc->chunksY) return false;
+    if (*cx0 < 0) *cx0 = 0;
+    if (*cy0 < 0) *cy0 = 0;
+    if (*cx1 >= tc->chunksX) *cx1 = tc->chunksX - 1;
+    if (*cy1 >= tc->chunksY) *cy1 = tc->chunksY - 1;
+    return true;
+}
+
+// Frees the least recently drawn texture not needed this frame
+static bool EvictOne(TilemapCache* tc) {
+    TilemapChunk* victim = nullptr;
+    for (TilemapChunk& c : tc->chunks) {
+        if (!c.resident || c.lastDrawn == tc->frame) continue;
+        if (!victim || c.lastDrawn < victim->lastDrawn) victim = &c;
+    }
+    if (!victim) return false;
+    UnloadRenderTexture(victim->rt);
+    victim->resident = false;
+    tc->stats.resident--;
+    return true;
+}
+
+static void BakeChunk(TilemapCache* tc, int cx, int cy, TilemapChunk* c) {
+    const int S  = TILEMAP_CHUNK_SIZE;
+    const Grid* g = tc->grid;
+
+    if (!c->resident) {
+        // Over the cap, make room; chunks on screen this frame are never evicted
+        if ((int)tc->stats.resident >= tc->maxResident) EvictOne(tc);
+        c->rt = LoadRenderTexture(S * TILE_SIZE, S * TILE_SIZE);
+        c->resident = true;
+        tc->stats.resident++;
+    }
+
+    const int x0 = cx * S, y0 = cy * S;
+    BeginTextureMode(c->rt);
+    ClearBackground(BLANK);
+    for (int y = y0; y < y0 + S && y < g->h; ++y)
+        for (int x = x0; x < x0 + S && x < g->w; ++x)
+            DrawRectangle((x - x0) * TILE_SIZE, (y - y0) * TILE_SIZE, TILE_SIZE, TILE_SIZE,
+                          TileColor(&g->t[y * g->w + x]));
+    EndTextureMode();
+
+    c->dirty = false;
+    tc->stats.bakes++;
+    tc->stats.totalBakes++;
+}
+
+void TilemapCache_Update(TilemapCache* tc, Camera2D cam, int screenW, int screenH) {
+    tc->frame++;
+    tc->stats.bakes = 0;
+    if (!tc->grid) return;
+
+    int cx0, cy0, cx1, cy1;
+    if (!VisibleChunks(tc, cam, screenW, screenH, &cx0, &cy0, &cx1, &cy1)) return;
+
+    for (int cy = cy0; cy <= cy1; ++cy)
+        for (int cx = cx0; cx <= cx1; ++cx) {
+            TilemapChunk& c = tc->chunks[(size_t)cy * tc->chunksX + cx];
+            c.lastDrawn = tc->frame;
+            if (!c.resident || c.dirty) BakeChunk(tc, cx, cy, &c);
+        }
+}
+
+void TilemapCache_Draw(TilemapCache* tc, Camera2D cam, int screenW, int screenH) {
+    tc->stats.drawCalls = 0;
+    tc->stats.chunksDrawn = 0;
+    if (!tc->grid) return;
+
+    int cx0, cy0, cx1, cy1;
+    if (!VisibleChunks(tc, cam, screenW, screenH, &cx0, &cy0, &cx1, &cy1)) return;
+
+    const float chunkPx = (float)(TILEMAP_CHUNK_SIZE * TILE_SIZE);
+    for (int cy = cy0; cy <= cy1; ++cy)
+        for (int cx = cx0; cx <= cx1; ++cx) {
+            const TilemapChunk& c = tc->chunks[(size_t)cy * tc->chunksX + cx];
+            if (!c.resident) continue;
+            // Render textures are stored bottom-up
+            const Rectangle src = { 0, 0, (float)c.rt.texture.width, -(float)c.rt.texture.height };
+            DrawTextureRec(c.rt.texture, src, (Vector2){ cx * chunkPx, cy * chunkPx }, WHITE);
+            tc->stats.drawCalls++;
+            tc->stats.chunksDrawn++;
+        }
+}
+
+void Tilemap_DrawImmediate(const Grid* g, TilemapStats* stats) {
+    for (int y = 0; y < g->h; ++y)
+        for (int x = 0; x < g->w; ++x)
+            DrawRectangle(x * TILE_SIZE, y * TILE_SIZE, TILE_SIZE, TILE_SIZE,
+                          TileColor(&g->t[y * g->w + x]));
+    if (stats) {
+        stats->drawCalls = (uint32_t)(g->w * g->h);
+        stats->chunksDrawn = 0;
+        stats->bakes = 0;
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "raylib.h"
+#include "../level/level.h"
+#include <cstdint>
+#include <vector>
+
+// Static tile layer baked into per-chunk render textures. Chunks are baked lazily when they
+// first come into view, re-baked only after their tiles change, and drawn only when they
+// intersect the camera view. Off-screen chunks beyond the residency cap give their
+// textures back, least recently drawn first, so huge maps keep a bounded VRAM footprint.
+
+#define TILEMAP_CHUNK_SIZE 16   // tiles per side: 512px textures at TILE_SIZE 32
+
+struct TilemapChunk {
+    RenderTexture2D rt;
+    bool            resident;   // rt holds a texture
+    bool            dirty;      // tiles changed since the last bake
+    uint32_t        lastDrawn;  // frame number
+};
+
+struct TilemapStats {
+    uint32_t drawCalls;         // texture or rectangle draws issued for tiles last frame
+    uint32_t chunksDrawn;
+    uint32_t bakes;             // last frame
+    uint32_t resident;
+    uint64_t totalBakes;
+};
+
+struct TilemapCache {
+    const Grid*               grid = nullptr;
+    int                       chunksX = 0, chunksY = 0;
+    int                       maxResident = 48;
+    uint32_t                  frame = 0;
+    std::vector<TilemapChunk> chunks;
+    TilemapStats              stats = {};
+};
+
+void TilemapCache_Init(TilemapCache* tc, const Grid* g, int maxResident);
+void TilemapCache_Free(TilemapCache* tc);
+
+// Marks tiles in [x, x+w) x [y, y+h) for re-baking
+void TilemapCache_Invalidate(TilemapCache* tc, int x, int y, int w, int h);
+
+// Bakes visible chunks that need it. Call outside BeginMode2D: texture mode resets the
+// camera transform.
+void TilemapCache_Update(TilemapCache* tc, Camera2D cam, int screenW, int screenH);
+
+// Draws the visible chunks. Call inside BeginMode2D(cam).
+void TilemapCache_Draw(TilemapCache* tc, Camera2D cam, int screenW, int screenH);
+
+// One DrawRectangle per tile over the whole map, the unbaked reference path
+void Tilemap_DrawImmediate(const Grid* g, TilemapStats* stats);
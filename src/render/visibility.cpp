@@ -0,0 +1,85 @@
+#include "visibility.h"
+#include "../entity/enemies.hpp"
+#include "../player/projectile.h"
+#include <algorithm>
+
+static const char* kVisNames[VIS_COUNT] = { "props", "enemies", "projectiles" };
+
+const char* VisKind_Name(int kind) {
+    return (kind >= 0 && kind < VIS_COUNT) ? kVisNames[kind] : "?";
+}
+
+Rectangle View_FromCamera(Camera2D cam, int screenW, int screenH) {
+    const Vector2 corners[4] = {
+        GetScreenToWorld2D((Vector2){ 0, 0 }, cam),
+        GetScreenToWorld2D((Vector2){ (float)screenW, 0 }, cam),
+        GetScreenToWorld2D((Vector2){ 0, (float)screenH }, cam),
+        GetScreenToWorld2D((Vector2){ (float)screenW, (float)screenH }, cam),
+    };
+    Vector2 mn = corners[0], mx = corners[0];
+    for (int i = 1; i < 4; ++i) {
+        mn.x = std::min(mn.x, corners[i].x);
+        mn.y = std::min(mn.y, corners[i].y);
+        mx.x = std::max(mx.x, corners[i].x);
+        mx.y = std::max(mx.y, corners[i].y);
+    }
+    return (Rectangle){ mn.x, mn.y, mx.x - mn.x, mx.y - mn.y };
+}
+
+static std::vector<int32_t> s_hits;
+
+void Visibility_Gather(VisibleSet* vis, const EntitySystem* es, Camera2D cam,
+                       int screenW, int screenH, float marginPx, bool countProps) {
+    vis->props.clear();
+    vis->enemies.clear();
+    vis->projectiles.clear();
+    vis->stats = VisStats{};
+
+    const Rectangle view = View_FromCamera(cam, screenW, screenH);
+    vis->view = view;
+
+    const Vector2 half   = { view.width * 0.5f + marginPx, view.height * 0.5f + marginPx };
+    const Vector2 center = { view.x + view.width * 0.5f, view.y + view.height * 0.5f };
+
+    // Props and enemies through the spatial hash
+    s_hits.clear();
+    Entities_QueryAABB(es, center, half, &s_hits);
+    for (int32_t i : s_hits) {
+        if (es->kind[i] == EntityKind::Prop) {
+            vis->props.push_back(i);
+        } else if (es->kind[i] == EntityKind::Enemy) {
+            auto it = g_enemyIndexByEntId.find(es->id[i]);
+            if (it != g_enemyIndexByEntId.end()) vis->enemies.push_back((int32_t)it->second);
+        }
+    }
+    // Keep the unculled draw order
+    std::sort(vis->props.begin(), vis->props.end());
+    std::sort(vis->enemies.begin(), vis->enemies.end());
+
+    // Projectiles: cached positions, no spatial index needed for a few dozen
+    const float x0 = center.x - half.x, x1 = center.x + half.x;
+    const float y0 = center.y - half.y, y1 = center.y + half.y;
+    int32_t liveProjectiles = 0;
+    for (size_t k = 0; k < g_projectiles.size(); ++k) {
+        const Projectile& p = g_projectiles[k];
+        if (!p.active) continue;
+        liveProjectiles++;
+        if (p.pos.x >= x0 && p.pos.x <= x1 && p.pos.y >= y0 && p.pos.y <= y1)
+            vis->projectiles.push_back((int32_t)k);
+    }
+
+    VisStats& s = vis->stats;
+    s.submitted[VIS_PROPS]       = (uint32_t)vis->props.size();
+    s.submitted[VIS_ENEMIES]     = (uint32_t)vis->enemies.size();
+    s.submitted[VIS_PROJECTILES] = (uint32_t)vis->projectiles.size();
+    s.culled[VIS_ENEMIES]        = (uint32_t)(g_enemies.size() - vis->enemies.size());
+    s.culled[VIS_PROJECTILES]    = (uint32_t)(liveProjectiles - (int32_t)vis->projectiles.size());
+
+    // There is no running prop total to derive it from, so this walks every entity
+    if (countProps) {
+        int32_t props = 0;
+        for (int32_t i = 0; i < Entities_Count(es); ++i)
+            if ((es->flags[i] & ENTITY_ACTIVE) && es->kind[i] == EntityKind::Prop) props++;
+        s.culled[VIS_PROPS] = (uint32_t)(props - (int32_t)vis->props.size());
+    }
+}
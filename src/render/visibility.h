@@ -0,0 +1,41 @@
+#pragma once
+#include "raylib.h"
+#include "../entity/entity.hpp"
+#include <cstdint>
+#include <vector>
+
+// Per-frame visibility pass: works out the world-space rect the camera sees and collects
+// what overlaps it, so the draw functions only submit on-screen objects. Props and enemies
+// come from the entity spatial hash; projectiles are few and tested directly.
+
+enum VisKind {
+    VIS_PROPS,
+    VIS_ENEMIES,
+    VIS_PROJECTILES,
+    VIS_COUNT
+};
+
+struct VisStats {
+    uint32_t submitted[VIS_COUNT];
+    uint32_t culled[VIS_COUNT];
+};
+
+struct VisibleSet {
+    Rectangle            view;          // world pixels, before the margin
+    std::vector<int32_t> props;         // dense entity indices, ascending
+    std::vector<int32_t> enemies;       // g_enemies indices, ascending
+    std::vector<int32_t> projectiles;   // g_projectiles indices, ascending
+    VisStats             stats = {};
+};
+
+// World rect covered by the camera (axis-aligned bound if the camera is rotated)
+Rectangle View_FromCamera(Camera2D cam, int screenW, int screenH);
+
+// Fills `vis` for this frame's camera. The view is widened by `marginPx` to cover sprites
+// larger than their collision box and movement between the last tick and the render time.
+// stats.culled[VIS_PROPS] is only counted when countProps is set (the F1 overlay is up) and
+// stays 0 otherwise.
+void Visibility_Gather(VisibleSet* vis, const EntitySystem* es, Camera2D cam,
+                       int screenW, int screenH, float marginPx, bool countProps);
+
+const char* VisKind_Name(int kind);
@@ -0,0 +1,838 @@
+#include "bench.h"
+#include "../entity/entity.hpp"
+#include "../entity/enemies.hpp"
+#include "../anims/animations.hpp"
+#include "../level/level.h"
+#include "../pathfinding/pathfinding.h"
+#include "../pathfinding/jps.h"
+#include "../jobs/jobs.h"
+#include "../game/game.h"
+#include "../physics/physics.h"
+#include "../state.h"
+#include <chrono>
+#include <thread>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+// False when a result disagrees with its reference implementation
+typedef bool (*BenchFn)(uint32_t seed);
+
+struct BenchRng {
+    uint32_t s;
+    uint32_t Next() { s ^= s << 13; s ^= s >> 17; s ^= s << 5; return s; }
+    int Range(int n) { return (int)(Next() % (uint32_t)n); }
+};
+
+static double NowMs() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Keeps results alive so the timed loops can't be optimised away
+static volatile int64_t s_sink;
+
+// A generated level the way Game_Init makes one
+static void BenchLevel(Grid* g, int w, int h, uint32_t seed) {
+    grid_init(g, w, h);
+    LevelGenParams params = level_gen_params(w, h, seed);
+    gen_level(g, &params);
+}
+
+static Vector2 RandomFloorPx(const Grid* g, BenchRng* rng) {
+    for (;;) {
+        const int x = rng->Range(g->w), y = rng->Range(g->h);
+        if (g->t[grid_idx(g, x, y)].id == TILE_FLOOR)
+            return { x * (float)TILE_SIZE + TILE_SIZE * 0.5f, y * (float)TILE_SIZE + TILE_SIZE * 0.5f };
+    }
+}
+
+// --- entities: slot-map lookup ------------------------------------------
+
+// The store before the slot map found entities by walking every id
+static int32_t LinearFind(const EntitySystem* es, int id) {
+    for (size_t i = 0; i < es->id.size(); ++i)
+        if (es->id[i] == id) return (es->flags[i] & ENTITY_ACTIVE) ? (int32_t)i : -1;
+    return -1;
+}
+
+static bool BenchEntities(uint32_t seed) {
+    printf("entity lookup: ns per lookup, random live ids (slot map vs the old linear scan)\n");
+    printf("%10s %12s %12s %12s\n", "entities", "slot map", "stale ids", "linear scan");
+
+    const int sizes[] = { 100, 1000, 10000, 100000 };
+    for (int n : sizes) {
+        BenchRng rng = { seed * 2654435761u | 1u };
+        EntitySystem es;
+        Entities_Init(&es, seed);
+
+        // Create, drop every other one and refill so ids and dense order are scrambled
+        std::vector<int> ids;
+        for (int i = 0; i < n; ++i)
+            ids.push_back(Entities_CreateBox(&es, EntityKind::Prop,
+                                             Vector2{ (float)rng.Range(4096), (float)rng.Range(4096) },
+                                             Vector2{ 8.0f, 8.0f }, WHITE));
+        std::vector<int> stale;
+        for (int i = 0; i < n; i += 2) {
+            Entities_Destroy(&es, ids[i]);
+            stale.push_back(ids[i]);
+            ids[i] = Entities_CreateBox(&es, EntityKind::Prop, Vector2{ 0.0f, 0.0f },
+                                        Vector2{ 8.0f, 8.0f }, WHITE);
+        }
+
+        const int lookups = 2000000;
+        std::vector<int> order((size_t)lookups);
+        for (int& k : order) k = ids[(size_t)rng.Range(n)];
+
+        int64_t sum = 0;
+        double t0 = NowMs();
+        for (int id : order) sum += Entities_Index(&es, id);
+        const double slotNs = (NowMs() - t0) * 1e6 / lookups;
+
+        t0 = NowMs();
+        for (int k = 0; k < lookups; ++k) sum += Entities_Index(&es, stale[(size_t)k % stale.size()]);
+        const double staleNs = (NowMs() - t0) * 1e6 / lookups;
+
+        // Quadratic territory: fewer lookups so the big sizes finish
+        const int scans = n >= 100000 ? 2000 : (n >= 10000 ? 20000 : 200000);
+        t0 = NowMs();
+        for (int k = 0; k < scans; ++k) sum += LinearFind(&es, order[(size_t)k]);
+        const double scanNs = (NowMs() - t0) * 1e6 / scans;
+
+        s_sink = sum;
+        printf("%10d %12.1f %12.1f %12.1f\n", n, slotNs, staleNs, scanNs);
+        Entities_Init(&es, seed);
+    }
+    return true;
+}
+
+// --- spatial: hash queries vs brute force ---------------------------------
+
+static void BruteRadius(const EntitySystem* es, Vector2 c, float r, std::vector<int32_t>* out) {
+    for (int32_t i = 0; i < Entities_Count(es); ++i) {
+        if (!(es->flags[i] & ENTITY_ACTIVE)) continue;
+        const float dx = es->pos[i].x - c.x, dy = es->pos[i].y - c.y;
+        if (dx * dx + dy * dy <= r * r) out->push_back(i);
+    }
+}
+
+static void BruteAABB(const EntitySystem* es, Vector2 c, Vector2 h, std::vector<int32_t>* out) {
+    for (int32_t i = 0; i < Entities_Count(es); ++i) {
+        if (!(es->flags[i] & ENTITY_ACTIVE)) continue;
+        if (std::fabs(es->pos[i].x - c.x) <= h.x + es->half[i].x &&
+            std::fabs(es->pos[i].y - c.y) <= h.y + es->half[i].y) out->push_back(i);
+    }
+}
+
+static bool BenchSpatial(uint32_t seed) {
+    const int n = 10000, queries = 2000;
+    const float world = 256.0f * TILE_SIZE;
+    BenchRng rng = { seed * 2654435761u | 1u };
+    auto randPos = [&]() { return Vector2{ (float)rng.Range((int)world), (float)rng.Range((int)world) }; };
+
+    // Props and enemy-sized boxes, then half of them moved the way the physics sync moves them
+    EntitySystem es;
+    Entities_Init(&es, seed);
+    for (int i = 0; i < n; ++i) {
+        const float h = (i % 4 == 0) ? 14.0f : 8.0f;
+        Entities_CreateBox(&es, EntityKind::Prop, randPos(), Vector2{ h, h }, WHITE);
+    }
+    for (int32_t i = 0; i < n; i += 2) {
+        es.pos[i].x = std::min(world, std::max(0.0f, es.pos[i].x + (float)(rng.Range(129) - 64)));
+        es.pos[i].y = std::min(world, std::max(0.0f, es.pos[i].y + (float)(rng.Range(129) - 64)));
+        SpatialHash_Move(&es.spatial, EntityId_Slot(es.id[i]), es.pos[i]);
+    }
+
+    std::vector<Vector2> centers((size_t)queries), extents((size_t)queries);
+    for (int q = 0; q < queries; ++q) {
+        centers[(size_t)q] = randPos();
+        extents[(size_t)q] = Vector2{ (float)(16 + rng.Range(240)), (float)(16 + rng.Range(240)) };
+    }
+
+    printf("spatial queries: %d entities on a %.0fpx square world, %d queries, us per query\n",
+           n, world, queries);
+    printf("%-8s %12s %12s %10s %10s\n", "query", "hash us/q", "brute us/q", "results", "mismatch");
+
+    std::vector<int32_t> got, want;
+    bool ok = true;
+    for (int kind = 0; kind < 2; ++kind) {
+        auto run = [&](bool brute, int q, std::vector<int32_t>* out) {
+            const Vector2 c = centers[(size_t)q], e = extents[(size_t)q];
+            if (kind == 0) brute ? BruteRadius(&es, c, e.x, out) : Entities_QueryRadius(&es, c, e.x, out);
+            else           brute ? BruteAABB(&es, c, e, out)     : Entities_QueryAABB(&es, c, e, out);
+        };
+
+        double ms[2];
+        int64_t found = 0;
+        for (int brute = 0; brute < 2; ++brute) {
+            const double t0 = NowMs();
+            for (int q = 0; q < queries; ++q) {
+                got.clear();
+                run(brute != 0, q, &got);
+                found += (int64_t)got.size();
+            }
+            ms[brute] = NowMs() - t0;
+        }
+        s_sink = found;
+
+        // Untimed: the same index sets, order aside
+        int mismatch = 0;
+        int64_t results = 0;
+        for (int q = 0; q < queries; ++q) {
+            got.clear();
+            want.clear();
+            run(false, q, &got);
+            run(true, q, &want);
+            std::sort(got.begin(), got.end());
+            mismatch += got != want;
+            results += (int64_t)want.size();
+        }
+        ok &= mismatch == 0;
+
+        printf("%-8s %12.2f %12.2f %10.1f %10d\n", kind == 0 ? "radius" : "aabb",
+               ms[0] * 1000.0 / queries, ms[1] * 1000.0 / queries, (double)results / queries, mismatch);
+    }
+    return ok;
+}
+
+// --- soa: component layout ---------------------------------------------
+
+// The layouts before the SoA split, field for field: every pass strode over all of it
+struct AosEntity {
+    int id;
+    EntityKind kind;
+    Vector2 pos;
+    Vector2 half;
+    Color color;
+    bool active;
+    ElementType element;
+    bool telekinetic;
+};
+
+struct AosEnemy {
+    int entId;
+    float health, maxHealth, slowTimer;
+    Animation runAnim;
+    EnemyAnimState animState;
+    bool facingRight;
+    std::vector<Vector2> path;
+    int waypoint;
+    float repathCd;
+};
+
+// Best of a few runs, in ns per element
+template <typename Fn>
+static double TimePass(int elements, int reps, Fn fn) {
+    double best = 1e30;
+    for (int r = 0; r < 5; ++r) {
+        double t0 = NowMs();
+        for (int k = 0; k < reps; ++k) fn();
+        best = std::min(best, (NowMs() - t0) * 1e6 / ((double)reps * elements));
+    }
+    return best;
+}
+
+static bool BenchSoa(uint32_t seed) {
+    const int n = 50000, reps = 200;
+    BenchRng rng = { seed * 2654435761u | 1u };
+
+    // Stand-in for the Box2D positions the sync loop copies from
+    std::vector<Vector2> bodyPos((size_t)n);
+    for (Vector2& p : bodyPos) p = { (float)rng.Range(4096), (float)rng.Range(4096) };
+
+    std::vector<AosEntity> aos((size_t)n);
+    EntitySystem es;
+    Entities_Init(&es, seed);
+    for (int i = 0; i < n; ++i) {
+        aos[(size_t)i] = { i + 1, EntityKind::Prop, bodyPos[(size_t)i], { 8, 8 }, WHITE, true,
+                           ElementType::NONE, false };
+        Entities_CreateBox(&es, EntityKind::Prop, bodyPos[(size_t)i], { 8, 8 }, WHITE);
+    }
+
+    // Entities_Update's position sync: flags + pos only
+    const double aosSync = TimePass(n, reps, [&] {
+        for (size_t i = 0; i < aos.size(); ++i) {
+            if (!aos[i].active) continue;
+            aos[i].pos = bodyPos[i];
+            bodyPos[i].x += 0.001f;
+        }
+    });
+    const double soaSync = TimePass(n, reps, [&] {
+        const int32_t count = Entities_Count(&es);
+        for (int32_t i = 0; i < count; ++i) {
+            if (!(es.flags[(size_t)i] & ENTITY_ACTIVE)) continue;
+            es.pos[(size_t)i] = bodyPos[(size_t)i];
+            bodyPos[(size_t)i].x += 0.001f;
+        }
+    });
+
+    // The health/slow part of the steering loop
+    std::vector<AosEnemy> aosEnemies((size_t)n);
+    std::vector<Enemy> enemies((size_t)n);
+    for (int i = 0; i < n; ++i) {
+        const float slow = (float)rng.Range(3);
+        aosEnemies[(size_t)i].health = enemies[(size_t)i].health = 100.0f;
+        aosEnemies[(size_t)i].slowTimer = enemies[(size_t)i].slowTimer = slow;
+    }
+    int64_t dead = 0;
+    const double aosSteer = TimePass(n, reps, [&] {
+        for (AosEnemy& en : aosEnemies) {
+            if (en.health <= 0.0f) { dead++; continue; }
+            en.slowTimer = en.slowTimer > 0.01f ? en.slowTimer - 0.01f : 2.0f;
+            en.repathCd -= 0.05f;
+        }
+    });
+    const double soaSteer = TimePass(n, reps, [&] {
+        for (Enemy& en : enemies) {
+            if (en.health <= 0.0f) { dead++; continue; }
+            en.slowTimer = en.slowTimer > 0.01f ? en.slowTimer - 0.01f : 2.0f;
+            en.repathCd -= 0.05f;
+        }
+    });
+    s_sink = dead;
+
+    printf("component layout: %d entities and %d enemies, ns per element (best of 5)\n", n, n);
+    printf("%-16s %12s %12s %14s %14s\n", "pass", "AoS ns", "SoA ns", "AoS B/elem", "SoA B/elem");
+    printf("%-16s %12.2f %12.2f %14zu %14zu\n", "position sync", aosSync, soaSync,
+           sizeof(AosEntity), sizeof(uint8_t) + sizeof(Vector2));
+    printf("%-16s %12.2f %12.2f %14zu %14zu\n", "enemy timers", aosSteer, soaSteer,
+           sizeof(AosEnemy), sizeof(Enemy));
+    return true;
+}
+
+// --- astar: old vs new search -------------------------------------------
+
+// A* as it was before PathContext: hash map of nodes and a priority_queue, both rebuilt
+// for every query. Kept verbatim apart from the name.
+static bool LegacyAStar(const Grid* g, Vector2 startPx, Vector2 goalPx, std::vector<Vector2>& outPath) {
+    static const int kDirs[4][2] = { {1,0},{-1,0},{0,1},{0,-1} };
+    struct Node { int x, y; float g, h; int parentX, parentY; };
+    auto heuristic = [](int x1, int y1, int x2, int y2) {
+        return fabsf((float)(x1 - x2)) + fabsf((float)(y1 - y2));
+    };
+    auto tile_center = [](int x, int y) -> Vector2 {
+        return { x * (float)TILE_SIZE + TILE_SIZE * 0.5f, y * (float)TILE_SIZE + TILE_SIZE * 0.5f };
+    };
+
+    outPath.clear();
+
+    const int W = g->w, H = g->h;
+    int sx = (int)(startPx.x / TILE_SIZE);
+    int sy = (int)(startPx.y / TILE_SIZE);
+    int gx = (int)(goalPx.x / TILE_SIZE);
+    int gy = (int)(goalPx.y / TILE_SIZE);
+
+    auto in_bounds = [&](int x, int y) { return x >= 0 && y >= 0 && x < W && y < H; };
+    auto passable  = [&](int x, int y) { Tile* t = grid_at((Grid*)g, x, y); return t && t->id == TILE_FLOOR; };
+
+    struct CellKey { int x, y; bool operator==(const CellKey& o) const { return x==o.x && y==o.y; } };
+    struct Hash { size_t operator()(const CellKey& c) const { return (size_t)c.x * 73856093 ^ (size_t)c.y * 19349663; } };
+
+    struct PQEntry { float f; CellKey key; };
+    struct PQCompare { bool operator()(const PQEntry& a, const PQEntry& b) const { return a.f > b.f; } };
+
+    std::priority_queue<PQEntry, std::vector<PQEntry>, PQCompare> open;
+    std::unordered_map<CellKey, Node, Hash> nodes;
+
+    CellKey start{sx, sy};
+    Node startNode{sx, sy, 0, heuristic(sx, sy, gx, gy), -1, -1};
+    nodes[start] = startNode;
+    open.push({ startNode.g + startNode.h, start });
+
+    bool found = false;
+    while (!open.empty()) {
+        CellKey curKey = open.top().key;
+        open.pop();
+
+        Node& cur = nodes[curKey];
+        if (cur.x == gx && cur.y == gy) { found = true; break; }
+
+        for (auto& d : kDirs) {
+            int nx = cur.x + d[0];
+            int ny = cur.y + d[1];
+            if (!in_bounds(nx, ny) || !passable(nx, ny)) continue;
+
+            CellKey nk{nx, ny};
+            float newG = cur.g + 1.0f;
+            auto it = nodes.find(nk);
+            if (it == nodes.end() || newG < it->second.g) {
+                Node next{nx, ny, newG, heuristic(nx, ny, gx, gy), cur.x, cur.y};
+                nodes[nk] = next;
+                open.push({ newG + next.h, nk });
+            }
+        }
+    }
+
+    if (!found) return false;
+
+    std::vector<Vector2> rev;
+    Node cur = nodes[{gx, gy}];
+    while (cur.parentX != -1) {
+        rev.push_back(tile_center(cur.x, cur.y));
+        cur = nodes[{cur.parentX, cur.parentY}];
+    }
+    std::reverse(rev.begin(), rev.end());
+    outPath = rev;
+    return true;
+}
+
+static bool BenchAStar(uint32_t seed) {
+    printf("A*: random floor-to-floor queries on generated levels (old = node map + priority_queue)\n");
+    printf("%-10s %8s %12s %12s %9s %10s\n", "map", "queries", "old us/q", "new us/q", "speedup", "mismatch");
+
+    struct Size { int w, h, queries; };
+    const Size sizes[] = { { 80, 45, 2000 }, { 1024, 1024, 200 } };
+    bool ok = true;
+    for (const Size& sz : sizes) {
+        Grid g = {};
+        BenchLevel(&g, sz.w, sz.h, seed);
+
+        BenchRng rng = { seed * 2654435761u | 1u };
+        std::vector<Vector2> starts((size_t)sz.queries), goals((size_t)sz.queries);
+        for (int i = 0; i < sz.queries; ++i) {
+            starts[(size_t)i] = RandomFloorPx(&g, &rng);
+            goals[(size_t)i]  = RandomFloorPx(&g, &rng);
+        }
+
+        std::vector<Vector2> path;
+        std::vector<size_t> oldLen((size_t)sz.queries);
+        double t0 = NowMs();
+        for (int i = 0; i < sz.queries; ++i) {
+            LegacyAStar(&g, starts[(size_t)i], goals[(size_t)i], path);
+            oldLen[(size_t)i] = path.size();
+        }
+        const double oldMs = NowMs() - t0;
+
+        // One untimed search sizes the context, as Pathfinding_SetLevel does in the game
+        PathContext ctx;
+        PathContext_Reserve(&ctx, &g);
+        int mismatch = 0;
+        t0 = NowMs();
+        for (int i = 0; i < sz.queries; ++i) {
+            AStar_FindPath(&ctx, &g, starts[(size_t)i], goals[(size_t)i], path);
+            mismatch += path.size() != oldLen[(size_t)i];
+        }
+        const double newMs = NowMs() - t0;
+
+        char name[16];
+        snprintf(name, sizeof(name), "%dx%d", sz.w, sz.h);
+        printf("%-10s %8d %12.1f %12.1f %8.1fx %10d\n", name, sz.queries, oldMs * 1000.0 / sz.queries,
+               newMs * 1000.0 / sz.queries, oldMs / newMs, mismatch);
+        ok &= mismatch == 0;
+        grid_free(&g);
+    }
+    return ok;
+}
+
+// --- flow: flow field vs per-enemy A* ---------------------------------------
+
+static bool BenchFlow(uint32_t seed) {
+    // Enemies repath every 0.35s (7 ticks) staggered; the player steps to a new tile every
+    // 4 ticks, so the field is rebuilt about every 4th tick
+    const int ticks = 140, repathEvery = 7, playerStepEvery = 4;
+
+    Grid g = {};
+    BenchLevel(&g, 80, 45, seed);
+    BenchRng rng = { seed * 2654435761u | 1u };
+
+    // Player route: A* between random floor tiles, chained until it covers every tick
+    std::vector<Vector2> route, leg;
+    Vector2 at = RandomFloorPx(&g, &rng);
+    route.push_back(at);
+    PathContext ctx;
+    while ((int)route.size() < ticks / playerStepEvery + 1) {
+        const Vector2 to = RandomFloorPx(&g, &rng);
+        if (!AStar_FindPath(&ctx, &g, at, to, leg)) continue;
+        route.insert(route.end(), leg.begin(), leg.end());
+        at = to;
+    }
+
+    printf("flow field vs per-enemy A*: ms per tick on an 80x45 level, %d ticks\n", ticks);
+    printf("%10s %12s %12s %9s\n", "enemies", "A* ms", "flow ms", "ratio");
+
+    const int counts[] = { 10, 100, 1000, 10000 };
+    for (int n : counts) {
+        std::vector<Vector2> pos((size_t)n);
+        for (Vector2& p : pos) p = RandomFloorPx(&g, &rng);
+        std::vector<std::vector<Vector2>> paths((size_t)n);
+        int64_t steps = 0;
+
+        double t0 = NowMs();
+        for (int t = 0; t < ticks; ++t) {
+            const Vector2 player = route[(size_t)(t / playerStepEvery)];
+            for (int i = t % repathEvery; i < n; i += repathEvery) {
+                AStar_FindPath(&ctx, &g, pos[(size_t)i], player, paths[(size_t)i]);
+                steps += (int64_t)paths[(size_t)i].size();
+            }
+        }
+        const double astarMs = (NowMs() - t0) / ticks;
+
+        FlowField ff;
+        t0 = NowMs();
+        for (int t = 0; t < ticks; ++t) {
+            FlowField_Update(&ff, &g, route[(size_t)(t / playerStepEvery)]);
+            Vector2 next;
+            for (int i = 0; i < n; ++i) steps += FlowField_Sample(&ff, pos[(size_t)i], &next);
+        }
+        const double flowMs = (NowMs() - t0) / ticks;
+        s_sink = steps;
+
+        printf("%10d %12.3f %12.3f %8.1fx\n", n, astarMs, flowMs, astarMs / flowMs);
+    }
+    grid_free(&g);
+    return true;
+}
+
+// --- batch: thread scaling -----------------------------------------------
+
+// FNV-1a over every result, to check the thread count changes nothing
+static uint64_t HashResults(const std::vector<PathRequest>& reqs) {
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&](uint32_t v) { h = (h ^ v) * 1099511628211ull; };
+    for (const PathRequest& r : reqs) {
+        mix(r.found);
+        for (const Vector2& p : *r.out) { mix((uint32_t)p.x); mix((uint32_t)p.y); }
+    }
+    return h;
+}
+
+static bool BenchBatch(uint32_t seed) {
+    const int count = 256, rounds = 4;
+    Grid g = {};
+    BenchLevel(&g, 1024, 1024, seed);
+    Pathfinding_SetLevel(&g);
+
+    BenchRng rng = { seed * 2654435761u | 1u };
+    std::vector<std::vector<Vector2>> out((size_t)count);
+    std::vector<PathRequest> reqs((size_t)count);
+    for (int i = 0; i < count; ++i)
+        reqs[(size_t)i] = { RandomFloorPx(&g, &rng), RandomFloorPx(&g, &rng), &out[(size_t)i], false };
+
+    // Past the core count the workers only share cores, but the results must still match
+    const int cores = (int)std::thread::hardware_concurrency();
+    const int maxThreads = std::max(cores, 4);
+    printf("Path_FindBatch: %d A* queries per batch on a 1024x1024 level, %d core(s)\n", count, cores);
+    printf("%8s %12s %9s %20s %20s\n", "threads", "ms/batch", "speedup", "result hash", "cached hash");
+
+    double baseMs = 0.0;
+    uint64_t baseHash = 0;
+    bool ok = true;
+    for (int threads = 1; ; threads = std::min(threads * 2, maxThreads)) {
+        JobSystem* js = Jobs_Create(threads);
+
+        double best = 1e30;
+        for (int r = 0; r < rounds; ++r) {
+            const double t0 = NowMs();
+            Path_FindBatch(nullptr, PathMode::AStar, &g, reqs.data(), count, js);
+            best = std::min(best, NowMs() - t0);
+        }
+        const uint64_t plain = HashResults(reqs);
+
+        // Through a cache as the game does: lookups and inserts must not depend on the split
+        PathCache cache;
+        PathCache_Init(&cache, 64);
+        Path_FindBatch(&cache, PathMode::AStar, &g, reqs.data(), count, js);
+        const uint64_t cached = HashResults(reqs);
+        Jobs_Destroy(js);
+
+        if (threads == 1) { baseMs = best; baseHash = plain; }
+        ok &= plain == baseHash && cached == baseHash;
+        printf("%8d %12.2f %8.2fx %20llx %20llx\n", threads, best, baseMs / best,
+               (unsigned long long)plain, (unsigned long long)cached);
+        if (threads == maxThreads) break;
+    }
+    grid_free(&g);
+    return ok;
+}
+
+// --- physics: Box2D step thread scaling ----------------------------------
+
+// The whole game on a 256x256 level with 4000 props and 1000 enemies, stepped the way
+// SpellForgeSim does with no input. Needs the sim's stub texture loader.
+static bool BenchPhysics(uint32_t seed) {
+    const int ticks = 300, warmup = 30;
+    const int cores = (int)std::thread::hardware_concurrency();
+    const int maxThreads = std::max(cores, 4);
+    printf("Box2D step: 256x256 level, 4000 props + 1000 enemies, %d ticks after %d warm-up, %d core(s)\n",
+           ticks, warmup, cores);
+    printf("%8s %10s %12s %12s %9s %10s\n", "threads", "bodies", "physics ms", "step ms", "speedup", "restarts");
+
+    double baseMs = 0.0;
+    for (int threads = 1; threads <= maxThreads; ++threads) {
+        g_jobs = Jobs_Create(threads);
+        g_gameOver = false;
+        g_enemiesKilled = 0;
+        g_wave = 0;
+        g_speedMultiplier = 1.0f;
+        g_lastWaveSpawned = 0;
+
+        Game game;
+        GameConfig config;
+        config.seed         = seed;
+        config.levelW       = 256;
+        config.levelH       = 256;
+        config.startEnemies = 1000;
+        config.minProps     = config.maxProps = 4000;
+        Game_Init(&game, &config);
+        const uint32_t bodies = g_bodyLinks.count;
+
+        SimInput in = {};
+        in.selectProjectile = -1;
+        int restarts = 0;
+        for (int t = 0; t < warmup + ticks; ++t) {
+            if (t == warmup) game.profile = GameProfile{};
+            if (g_gameOver) {
+                Game_Restart(&game);
+                restarts++;
+            }
+            in.aimWorld = game.player.pos;
+            Game_Step(&game, &in, tick);
+        }
+
+        const GameProfile& p = game.profile;
+        double stepUs = 0.0;
+        for (int k = 0; k < GT_COUNT; ++k) stepUs += p.totalUs[k];
+        const double physicsMs = p.totalUs[GT_PHYSICS] / 1000.0 / (double)p.ticks;
+        if (threads == 1) baseMs = physicsMs;
+        printf("%8d %10u %12.3f %12.3f %8.2fx %10d\n", threads, bodies, physicsMs,
+               stepUs / 1000.0 / (double)p.ticks, baseMs / physicsMs, restarts);
+
+        Game_Shutdown(&game);
+        Jobs_Destroy(g_jobs);
+        g_jobs = nullptr;
+    }
+    return true;
+}
+
+// --- hpa: nodes expanded vs A* -------------------------------------------
+
+static bool BenchHpa(uint32_t seed) {
+    printf("HPA* vs A*: nodes popped per query, random floor-to-floor queries\n");
+    printf("%-10s %8s %10s %10s %10s %10s %10s\n", "map", "queries", "A* nodes", "HPA abs",
+           "HPA tiles", "A* us/q", "HPA us/q");
+
+    struct Size { int w, h, queries; };
+    const Size sizes[] = { { 80, 45, 2000 }, { 256, 256, 1000 }, { 1024, 1024, 200 } };
+    for (const Size& sz : sizes) {
+        Grid g = {};
+        BenchLevel(&g, sz.w, sz.h, seed);
+        Pathfinding_SetLevel(&g);
+
+        BenchRng rng = { seed * 2654435761u | 1u };
+        std::vector<Vector2> starts((size_t)sz.queries), goals((size_t)sz.queries);
+        for (int i = 0; i < sz.queries; ++i) {
+            starts[(size_t)i] = RandomFloorPx(&g, &rng);
+            goals[(size_t)i]  = RandomFloorPx(&g, &rng);
+        }
+
+        // HPA* paths stop after the refined leading part, so only the work is comparable
+        std::vector<Vector2> path;
+        double ms[2];
+        const PathMode modes[2] = { PathMode::AStar, PathMode::Hierarchical };
+        for (int m = 0; m < 2; ++m) {
+            if (m == 0) Path_ResetSearchStats();
+            const double t0 = NowMs();
+            for (int i = 0; i < sz.queries; ++i)
+                Path_Find(modes[m], &g, starts[(size_t)i], goals[(size_t)i], path);
+            ms[m] = NowMs() - t0;
+        }
+        const PathSearchStats st = Path_SearchStats();
+
+        char name[16];
+        snprintf(name, sizeof(name), "%dx%d", sz.w, sz.h);
+        printf("%-10s %8d %10.0f %10.0f %10.0f %10.1f %10.1f\n", name, sz.queries,
+               (double)st.expanded / sz.queries, (double)st.hpaAbstractExpanded / sz.queries,
+               (double)st.hpaRefineExpanded / sz.queries,
+               ms[0] * 1000.0 / sz.queries, ms[1] * 1000.0 / sz.queries);
+        grid_free(&g);
+    }
+    return true;
+}
+
+// --- jps: JPS+ vs A* ----------------------------------------------------
+
+static bool BenchJps(uint32_t seed) {
+    printf("JPS+ vs A*: same random floor-to-floor queries, nodes popped summed over all queries\n");
+    printf("%-10s %8s %12s %12s %10s %10s %10s\n", "map", "queries", "A* nodes", "JPS+ nodes",
+           "A* us/q", "JPS us/q", "mismatch");
+
+    struct Size { int w, h, queries; };
+    const Size sizes[] = { { 80, 45, 2000 }, { 256, 256, 1000 }, { 1024, 1024, 200 } };
+    bool ok = true;
+    for (const Size& sz : sizes) {
+        Grid g = {};
+        BenchLevel(&g, sz.w, sz.h, seed);
+        JpsTables jt;
+        Jps_Build(&jt, &g);
+
+        BenchRng rng = { seed * 2654435761u | 1u };
+        std::vector<Vector2> starts((size_t)sz.queries), goals((size_t)sz.queries);
+        for (int i = 0; i < sz.queries; ++i) {
+            starts[(size_t)i] = RandomFloorPx(&g, &rng);
+            goals[(size_t)i]  = RandomFloorPx(&g, &rng);
+        }
+
+        PathContext ctx;
+        PathContext_Reserve(&ctx, &g);
+        std::vector<Vector2> path;
+        std::vector<size_t> astarLen((size_t)sz.queries);
+        uint64_t astarNodes = 0;
+        double t0 = NowMs();
+        for (int i = 0; i < sz.queries; ++i) {
+            AStar_FindPath(&ctx, &g, starts[(size_t)i], goals[(size_t)i], path);
+            astarNodes += ctx.lastExpanded;
+            astarLen[(size_t)i] = path.size();
+        }
+        const double astarMs = NowMs() - t0;
+
+        uint64_t jpsNodes = 0;
+        int mismatch = 0;
+        t0 = NowMs();
+        for (int i = 0; i < sz.queries; ++i) {
+            Jps_FindPath(&ctx, &jt, &g, starts[(size_t)i], goals[(size_t)i], path);
+            jpsNodes += ctx.lastExpanded;
+            mismatch += path.size() != astarLen[(size_t)i];
+        }
+        const double jpsMs = NowMs() - t0;
+
+        char name[16];
+        snprintf(name, sizeof(name), "%dx%d", sz.w, sz.h);
+        printf("%-10s %8d %12llu %12llu %10.1f %10.1f %10d\n", name, sz.queries,
+               (unsigned long long)astarNodes, (unsigned long long)jpsNodes,
+               astarMs * 1000.0 / sz.queries, jpsMs * 1000.0 / sz.queries, mismatch);
+        ok &= mismatch == 0;
+        grid_free(&g);
+    }
+    return ok;
+}
+
+// --- walk: bitmap scans vs the per-tile loops --------------------------
+
+// The tile loops the walkability bitmap replaced: (2r+1)x(2r+1) all floor, out of bounds blocks
+static bool ScalarClearance(const Grid* g, int x, int y, int r) {
+    for (int dy = -r; dy <= r; ++dy)
+        for (int dx = -r; dx <= r; ++dx) {
+            Tile* t = grid_at((Grid*)g, x + dx, y + dy);
+            if (!t || t->id != TILE_FLOOR) return false;
+        }
+    return true;
+}
+
+static void ScalarCandidates(const Grid* g, int r, std::vector<int>* out) {
+    out->clear();
+    for (int y = 0; y < g->h; ++y)
+        for (int x = 0; x < g->w; ++x)
+            if (ScalarClearance(g, x, y, r)) out->push_back(y * g->w + x);
+}
+
+static void WalkCandidates(const Grid* g, int r, std::vector<int>* out, std::vector<uint64_t>* clear) {
+    out->clear();
+    clear->resize((size_t)g->walkStride);
+    for (int y = 0; y < g->h; ++y) {
+        grid_walk_clearance_row(g, y, r, clear->data());
+        for (int j = 0; j < g->walkStride; ++j)
+            for (uint64_t bits = (*clear)[(size_t)j]; bits; bits &= bits - 1)
+                out->push_back(y * g->w + walk_bit_x(j, walk_ctz(bits)));
+    }
+}
+
+// The outline pass gen_level used to end with: walls next to floor. Counts the tiles it
+// would change, which is none since carving only writes floor.
+static int ScalarOutlineChanges(const Grid* g) {
+    int changed = 0;
+    for (int y = 1; y < g->h - 1; ++y)
+        for (int x = 1; x < g->w - 1; ++x) {
+            const Tile& t = g->t[grid_idx(g, x, y)];
+            if (t.id == TILE_FLOOR) continue;
+            changed += t.id != TILE_WALL || t.flags != TF_OPAQUE;
+        }
+    return changed;
+}
+
+static bool BenchWalk(uint32_t seed) {
+    printf("walkability bitmap vs per-tile loops on generated levels, ms per full-map scan (best of 3)\n");
+    printf("%-10s %-22s %10s %10s %10s %10s\n", "map", "scan", "tiles ms", "bits ms", "found", "mismatch");
+
+    const int sizes[] = { 1024, 2048 };
+    bool ok = true;
+    for (int n : sizes) {
+        Grid g = {};
+        BenchLevel(&g, n, n, seed);
+        char name[16];
+        snprintf(name, sizeof(name), "%dx%d", n, n);
+
+        // r=1 is the prop spawn candidate set, r=3 the FindFloorSpawn one
+        const int radii[] = { 1, 3 };
+        const char* what[] = { "spawn candidates r=1", "FindFloorSpawn r=3" };
+        std::vector<int> want, got;
+        std::vector<uint64_t> clear;
+        for (int k = 0; k < 2; ++k) {
+            double ms[2] = { 1e30, 1e30 };
+            for (int rep = 0; rep < 3; ++rep) {
+                double t0 = NowMs();
+                ScalarCandidates(&g, radii[k], &want);
+                ms[0] = std::min(ms[0], NowMs() - t0);
+                t0 = NowMs();
+                WalkCandidates(&g, radii[k], &got, &clear);
+                ms[1] = std::min(ms[1], NowMs() - t0);
+            }
+            const int mismatch = got == want ? 0 : 1;
+            ok &= mismatch == 0;
+            printf("%-10s %-22s %10.2f %10.2f %10zu %10d\n", name, what[k], ms[0], ms[1], want.size(), mismatch);
+        }
+
+        // Removed rather than rewritten: check it really had nothing left to do
+        const double t0 = NowMs();
+        const int changes = ScalarOutlineChanges(&g);
+        const double outlineMs = NowMs() - t0;
+        ok &= changes == 0;
+        printf("%-10s %-22s %10.2f %10s %10d %10d\n", name, "outline (removed)", outlineMs, "-", changes, changes);
+        grid_free(&g);
+    }
+    return ok;
+}
+
+// --- registry ----------------------------------------------------------
+
+struct BenchEntry {
+    const char* name;
+    const char* what;
+    BenchFn     fn;
+};
+
+static const BenchEntry kBenches[] = {
+    { "entities", "entity id lookup, 100 to 100k entities",      BenchEntities },
+    { "spatial",  "spatial hash queries vs brute force at 10k",  BenchSpatial },
+    { "astar",    "old vs new A* on 80x45 and 1024x1024 levels",  BenchAStar },
+    { "flow",     "flow field vs per-enemy A*, 10 to 10k enemies", BenchFlow },
+    { "batch",    "Path_FindBatch from 1 thread to every core",   BenchBatch },
+    { "physics",  "Box2D step with 5000 bodies, 1 thread to every core", BenchPhysics },
+    { "hpa",      "HPA* vs A* nodes expanded, 80x45 to 1024x1024", BenchHpa },
+    { "jps",      "JPS+ vs A* path lengths and nodes expanded",   BenchJps },
+    { "soa",      "AoS vs SoA hot loops at 50k entities",        BenchSoa },
+    { "walk",     "walkability bitmap scans vs tile loops, 1024^2 and 2048^2", BenchWalk },
+};
+
+void Bench_PrintList() {
+    for (const BenchEntry& b : kBenches) printf("    %-10s %s\n", b.name, b.what);
+    printf("    %-10s %s\n", "all", "every benchmark above");
+}
+
+int Bench_Run(const char* name, uint32_t seed) {
+    bool ran = false, ok = true;
+    for (const BenchEntry& b : kBenches) {
+        if (strcmp(name, "all") != 0 && strcmp(name, b.name) != 0) continue;
+        if (ran) printf("\n");
+        if (!b.fn(seed)) {
+            printf("FAILED: %s results disagree with the reference\n", b.name);
+            ok = false;
+        }
+        ran = true;
+    }
+    if (!ran) return -1;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include <cstdint>
+
+// Microbenchmarks behind SpellForgeSim --bench NAME. Each one builds just the data it needs
+// (levels, entity stores, job pools; only physics builds a whole game) and prints a small
+// table. Same seed -> same inputs.
+
+// Runs the named benchmark ("all" runs every one). Returns the exit code: 0 when every
+// result matched its reference, 1 when one disagreed, -1 if the name is unknown.
+int Bench_Run(const char* name, uint32_t seed);
+
+// One line per benchmark, for --help
+void Bench_PrintList();
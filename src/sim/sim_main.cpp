@@ -0,0 +1,448 @@
+// SpellForgeSim: runs the game headless for a fixed number of ticks with scripted input and
+// reports where the time goes. No window or GPU is created; textures come from a stub
+// loader. Same seed and options -> same run, so numbers are comparable between builds.
+#include "raylib.h"
+#include "raymath.h"
+#include "../game/game.h"
+#include "../physics/physics.h"
+#include "../physics/contacts.h"
+#include "../player/projectile.h"
+#include "../entity/enemies.hpp"
+#include "../pathfinding/pathfinding.h"
+#include "../anims/texture_cache.hpp"
+#include "../jobs/jobs.h"
+#include "../memory/arena.h"
+#include "../state.h"
+#include "bench.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+struct SimOptions {
+    int      ticks   = 3600;
+    uint32_t seed    = 1;
+    int      threads = 0;       // 0 -> hardware concurrency
+    int      width   = 80;
+    int      height  = 45;
+    int      enemies = 10;
+    int      props   = -1;      // -1 -> the game's default 10..20
+    PathMode path    = PathMode::AStar;
+    int      warmup  = 300;     // ticks before heap allocations count as steady state
+    int      volley  = 1;       // projectiles per shot, >1 stresses contact dispatch
+    int      burst   = 0;       // enemies spawned at once after init, timed
+    int      restartBench = 0;  // soft and hard restarts timed after init
+    int      toggleTiles  = 0;  // every N ticks flip a 3x3 block between wall and floor
+    bool     verbose = false;
+    const char* bench = nullptr;  // run this microbenchmark instead of the game
+};
+
+static void PrintUsage() {
+    printf("usage: SpellForgeSim [options]\n"
+           "  --ticks N        ticks to simulate (default 3600)\n"
+           "  --seed N         level/spawn/input seed, non-zero (default 1)\n"
+           "  --threads N      job system threads, 0 = all cores (default 0)\n"
+           "  --size WxH       level size in tiles (default 80x45)\n"
+           "  --enemies N      enemies at start (default 10)\n"
+           "  --props N        props at start (default 10..20)\n"
+           "  --path MODE      astar | flow | hpa | jps (default astar)\n"
+           "  --warmup N       ticks before counting steady-state allocations (default 300)\n"
+           "  --volley N       projectiles per shot, fanned out (default 1)\n"
+           "  --burst N        spawn N more enemies at once after init and time it (default 0)\n"
+           "  --restart-bench N  time N soft and N world-rebuilding restarts after init (default 0)\n"
+           "  --toggle-tiles N every N ticks flip a 3x3 block of tiles and check the rebuild (default 0)\n"
+           "  --verbose        keep game logging on\n"
+           "  --bench NAME     run a microbenchmark and exit:\n");
+    Bench_PrintList();
+}
+
+static bool ParsePathMode(const char* s, PathMode* out) {
+    if (strcmp(s, "astar") == 0) { *out = PathMode::AStar;        return true; }
+    if (strcmp(s, "flow")  == 0) { *out = PathMode::FlowField;    return true; }
+    if (strcmp(s, "hpa")   == 0) { *out = PathMode::Hierarchical; return true; }
+    if (strcmp(s, "jps")   == 0) { *out = PathMode::JumpPoint;    return true; }
+    return false;
+}
+
+static bool ParseArgs(int argc, char** argv, SimOptions* o) {
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        bool used = true;
+
+        if      (!strcmp(a, "--ticks") && v)   o->ticks   = atoi(v);
+        else if (!strcmp(a, "--seed") && v)    o->seed    = (uint32_t)strtoul(v, nullptr, 10);
+        else if (!strcmp(a, "--threads") && v) o->threads = atoi(v);
+        else if (!strcmp(a, "--enemies") && v) o->enemies = atoi(v);
+        else if (!strcmp(a, "--props") && v)   o->props   = atoi(v);
+        else if (!strcmp(a, "--warmup") && v)  o->warmup  = atoi(v);
+        else if (!strcmp(a, "--volley") && v)  o->volley  = atoi(v);
+        else if (!strcmp(a, "--burst") && v)   o->burst   = atoi(v);
+        else if (!strcmp(a, "--restart-bench") && v) o->restartBench = atoi(v);
+        else if (!strcmp(a, "--toggle-tiles") && v)  o->toggleTiles  = atoi(v);
+        else if (!strcmp(a, "--bench") && v)   o->bench   = v;
+        else if (!strcmp(a, "--size") && v) {
+            if (sscanf(v, "%dx%d", &o->width, &o->height) != 2) return false;
+        }
+        else if (!strcmp(a, "--path") && v) {
+            if (!ParsePathMode(v, &o->path)) return false;
+        }
+        else {
+            used = false;
+            if (!strcmp(a, "--verbose")) o->verbose = true;
+            else return false;
+        }
+        if (used) ++i;
+    }
+    return o->ticks > 0 && o->seed != 0 && o->width >= 16 && o->height >= 16 && o->enemies >= 0 &&
+           o->warmup >= 0 && o->toggleTiles >= 0;
+}
+
+// --- allocation counting -------------------------------------------------
+
+// Every operator new in the process and every Box2D allocation passes through here, so the
+// report can show what a tick still takes from the heap once the game has warmed up.
+static std::atomic<uint64_t> s_heapAllocs{0};
+
+void* operator new(size_t size) {
+    s_heapAllocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept         { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static void* CountingB2Alloc(unsigned int size, int alignment) {
+    s_heapAllocs.fetch_add(1, std::memory_order_relaxed);
+    size = (size + alignment - 1) & ~(unsigned int)(alignment - 1);
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    return aligned_alloc((size_t)alignment, size);
+#endif
+}
+
+static void CountingB2Free(void* mem) {
+#ifdef _WIN32
+    _aligned_free(mem);
+#else
+    free(mem);
+#endif
+}
+
+// Heap traffic an arena caused: overflow allocations and block regrowth
+static uint64_t ArenaHeapAllocs(const Arena* a) {
+    return a->stats.overflows + a->stats.regrows;
+}
+
+struct AllocReport {
+    uint64_t steadyAllocs = 0;  // heap allocations inside Game_Step after the warm-up
+    int      steadyTicks  = 0;
+    int      allocTicks   = 0;  // steady ticks that allocated at all
+};
+
+struct BurstReport {
+    int    enemies  = 0;    // actually placed
+    double spawnMs  = 0.0;  // entities + enemy records
+    double bodiesMs = 0.0;  // Box2D bodies + links
+};
+
+struct RestartReport {
+    double softMs = 0.0, softMaxMs = 0.0;   // world kept
+    double hardMs = 0.0, hardMaxMs = 0.0;   // world destroyed and rebuilt
+};
+
+struct TileReport {
+    int    edits  = 0;
+    int    chunks = 0;          // collider chunks rebuilt
+    double ms     = 0.0;        // Game_SetTiles total
+    int    walkMismatches = 0;  // tiles whose walk bit disagrees with the tile after an edit
+    int    shapesEdited   = 0;  // wall segments after all the edits
+    int    shapesRebuilt  = 0;  // the same after rebuilding every chunk, must match
+};
+
+// --- stub assets -------------------------------------------------------
+
+static Texture2D StubLoadTexture(const char* /*path*/) {
+    Texture2D t = {};
+    t.id = 1;            // non-zero so it looks loaded
+    t.width = 128;       // 4 frames of 32x32, like the real sheets
+    t.height = 32;
+    t.mipmaps = 1;
+    return t;
+}
+
+static void StubUnloadTexture(Texture2D /*tex*/) {}
+
+// --- scripted player ---------------------------------------------------
+
+struct ScriptState {
+    uint32_t rng;
+    Vector2  move;
+};
+
+static uint32_t ScriptRand(ScriptState* s) {
+    uint32_t x = s->rng;
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    return s->rng = x;
+}
+
+// Wanders in 8 directions, shoots at the nearest enemy, and periodically grabs and throws
+// props, switching element every few seconds. Depends only on the seed and game state.
+static SimInput ScriptInput(ScriptState* s, const Game* game, int tick) {
+    SimInput in = {};
+    in.selectProjectile = -1;
+
+    if (tick % 30 == 0) {
+        int d = (int)(ScriptRand(s) % 9);
+        in.move = d == 8 ? Vector2{ 0, 0 } : Vector2{ (float)(d % 3) - 1.0f, (float)(d / 3) - 1.0f };
+        s->move = in.move;
+    }
+    in.move = s->move;
+
+    const Vector2 me = game->player.pos;
+    float best = 1e30f;
+    in.aimWorld = Vector2Add(me, Vector2{ 1.0f, 0.0f });
+    for (const Enemy& en : g_enemies) {
+        int32_t e = Entities_Index(&game->ents, en.entId);
+        if (e < 0) continue;
+        float d = Vector2Distance(me, game->ents.pos[e]);
+        if (d < best) { best = d; in.aimWorld = game->ents.pos[e]; }
+    }
+    in.fire = (tick % 6) == 0;
+
+    const int tk = tick % 200;
+    in.holdTelekinesis    = tk >= 120 && tk < 160;
+    in.releaseTelekinesis = tk == 160;
+
+    if (tick % 300 == 0)
+        in.selectProjectile = (int8_t)((tick / 300) % 2 ? ProjectileType::ICE : ProjectileType::FIRE);
+    return in;
+}
+
+// One wave of count enemies, the way SpawnWave does it, timed in two halves
+static void SpawnBurst(Game* game, int count, BurstReport* out) {
+    const size_t before  = g_enemies.size();
+    const size_t prevEnt = (size_t)Entities_Count(&game->ents);
+
+    auto t0 = std::chrono::steady_clock::now();
+    Enemies_Spawn(&game->ents, &game->grid, game->player.pos, count, 200.0f);
+    auto t1 = std::chrono::steady_clock::now();
+    Enemies_CreateBodies(&game->ents, game->world, prevEnt);
+    auto t2 = std::chrono::steady_clock::now();
+
+    out->enemies  = (int)(g_enemies.size() - before);
+    out->spawnMs  = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    out->bodiesMs = std::chrono::duration<double, std::milli>(t2 - t1).count();
+}
+
+// count restarts each way from the same starting state. Leaves a freshly restarted game.
+static void RestartBench(Game* game, int count, RestartReport* out) {
+    for (int pass = 0; pass < 2; ++pass) {
+        const bool hard = pass == 1;
+        double total = 0.0, worst = 0.0;
+        for (int i = 0; i < count; ++i) {
+            auto t0 = std::chrono::steady_clock::now();
+            Game_Restart(game, hard);
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            total += ms;
+            worst = std::max(worst, ms);
+        }
+        (hard ? out->hardMs : out->softMs)       = total / count;
+        (hard ? out->hardMaxMs : out->softMaxMs) = worst;
+    }
+}
+
+// Flips a 3x3 block at least 4 tiles from the player and checks grid_sync_walk around it
+static void ToggleTiles(Game* game, ScriptState* s, TileReport* out) {
+    Grid* g = &game->grid;
+    const int px = (int)(game->player.pos.x / TILE_SIZE), py = (int)(game->player.pos.y / TILE_SIZE);
+    int x, y;
+    do {
+        x = 1 + (int)(ScriptRand(s) % (uint32_t)(g->w - 4));
+        y = 1 + (int)(ScriptRand(s) % (uint32_t)(g->h - 4));
+    } while (abs(x + 1 - px) < 4 && abs(y + 1 - py) < 4);
+
+    const bool toFloor = grid_at(g, x + 1, y + 1)->id == TILE_WALL;
+    auto t0 = std::chrono::steady_clock::now();
+    out->chunks += Game_SetTiles(game, x, y, 3, 3, toFloor ? TILE_FLOOR : TILE_WALL,
+                                 toFloor ? TF_WALKABLE : TF_OPAQUE);
+    out->ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    out->edits++;
+
+    for (int ty = y - 1; ty <= y + 3; ++ty)
+        for (int tx = x - 1; tx <= x + 3; ++tx)
+            out->walkMismatches += grid_walk_bit(g, tx, ty) != (grid_at(g, tx, ty)->id == TILE_FLOOR);
+}
+
+// Extra shots around the scripted aim; Game_Step fires the centre one
+static void FireVolley(Game* game, const SimInput* in, int count) {
+    const Vector2 me  = game->player.pos;
+    const Vector2 dir = Vector2Subtract(in->aimWorld, me);
+    for (int k = 1; k < count; ++k) {
+        const float angle = (k % 2 ? 1.0f : -1.0f) * (float)((k + 1) / 2) * 0.08f;
+        Projectile_Shoot(game->world, me, Vector2Add(me, Vector2Rotate(dir, angle)));
+    }
+}
+
+// --- report ------------------------------------------------------------
+
+static void PrintReport(const Game* game, const SimOptions* o, double wallMs, int restarts,
+                        const AllocReport* alloc, const BurstReport* burst,
+                        const RestartReport* restart, const TileReport* tiles) {
+    const GameProfile& p = game->profile;
+    double stepUs = 0.0;
+    for (int t = 0; t < GT_COUNT; ++t) stepUs += p.totalUs[t];
+
+    printf("SpellForgeSim  seed=%u  level=%dx%d  path=%s  threads=%d\n",
+           o->seed, o->width, o->height, PathMode_Name(o->path), Jobs_WorkerCount(g_jobs));
+    printf("ticks=%llu  wall=%.1fms  ticks/s=%.0f  avg tick=%.1fus\n",
+           (unsigned long long)p.ticks, wallMs, p.ticks / (wallMs / 1000.0),
+           p.ticks ? stepUs / p.ticks : 0.0);
+    printf("\n%-12s %10s %10s %7s\n", "subsystem", "avg us", "max us", "share");
+    for (int t = 0; t < GT_COUNT; ++t) {
+        printf("%-12s %10.2f %10.1f %6.1f%%\n", GameTimer_Name(t),
+               p.ticks ? p.totalUs[t] / p.ticks : 0.0, p.maxUs[t],
+               stepUs > 0.0 ? 100.0 * p.totalUs[t] / stepUs : 0.0);
+    }
+
+    const TextureCacheStats& tex = TextureCache_Stats();
+    printf("\nkills=%d  waves=%d  restarts=%d  entities=%d  enemies=%zu  projectiles=%d\n",
+           g_enemiesKilled, g_wave, restarts, Entities_Count(&game->ents), g_enemies.size(),
+           Projectile_LiveCount());
+    printf("projectile pool: fired=%llu bodies created=%llu peak live=%d\n",
+           (unsigned long long)g_projectilePoolStats.fired,
+           (unsigned long long)g_projectilePoolStats.created, g_projectilePoolStats.peakLive);
+    printf("path cache: hits=%llu suffix=%llu misses=%llu invalidations=%llu   "
+           "repath depth=%u p99=%.0fus serviced=%llu\n",
+           (unsigned long long)g_pathCache.stats.hits,
+           (unsigned long long)g_pathCache.stats.suffixHits,
+           (unsigned long long)g_pathCache.stats.misses,
+           (unsigned long long)g_pathCache.stats.invalidations,
+           g_repath.stats.queueDepth, g_repath.stats.p99FrameUs,
+           (unsigned long long)g_repath.stats.totalServiced);
+    const PathSearchStats search = Path_SearchStats();
+    printf("path search: searches=%llu expanded/search=%.0f",
+           (unsigned long long)search.searches,
+           search.searches ? (double)search.expanded / search.searches : 0.0);
+    if (search.hpaSearches)
+        printf("   hpa: searches=%llu abstract/search=%.0f refine/search=%.0f",
+               (unsigned long long)search.hpaSearches,
+               (double)search.hpaAbstractExpanded / search.hpaSearches,
+               (double)search.hpaRefineExpanded / search.hpaSearches);
+    printf("\n");
+    printf("textures: loads=%llu hits=%llu resident=%u\n",
+           (unsigned long long)tex.loads, (unsigned long long)tex.hits, tex.resident);
+    printf("contacts: events=%llu player-enemy=%llu projectile=%llu prop-enemy=%llu ignored=%llu\n",
+           (unsigned long long)g_contactStats.events, (unsigned long long)g_contactStats.playerEnemy,
+           (unsigned long long)g_contactStats.projectile, (unsigned long long)g_contactStats.propEnemy,
+           (unsigned long long)g_contactStats.ignored);
+    if (o->burst > 0)
+        printf("spawn burst: %d enemies  spawn=%.2fms  bodies=%.2fms\n",
+               burst->enemies, burst->spawnMs, burst->bodiesMs);
+    if (o->restartBench > 0)
+        printf("restart x%d: soft avg=%.2fms max=%.2fms   rebuild avg=%.2fms max=%.2fms\n",
+               o->restartBench, restart->softMs, restart->softMaxMs, restart->hardMs, restart->hardMaxMs);
+    if (o->toggleTiles > 0)
+        printf("tile edits: %d  chunks rebuilt=%d  avg=%.2fms  walk mismatches=%d  "
+               "wall segments=%d (full rebuild %d)\n",
+               tiles->edits, tiles->chunks, tiles->edits ? tiles->ms / tiles->edits : 0.0,
+               tiles->walkMismatches, tiles->shapesEdited, tiles->shapesRebuilt);
+    printf("heap: %llu allocs in %d of %d steady ticks (after %d warm-up)\n",
+           (unsigned long long)alloc->steadyAllocs, alloc->allocTicks, alloc->steadyTicks, o->warmup);
+    printf("arenas: frame peak=%zuB overflows=%llu   level peak=%zuB overflows=%llu\n",
+           g_frameArena.stats.peakBytes, (unsigned long long)g_frameArena.stats.overflows,
+           g_levelArena.stats.peakBytes, (unsigned long long)g_levelArena.stats.overflows);
+}
+
+int main(int argc, char** argv) {
+    SimOptions opt;
+    if (!ParseArgs(argc, argv, &opt)) {
+        PrintUsage();
+        return 1;
+    }
+
+    SetTraceLogLevel(opt.verbose ? LOG_INFO : LOG_WARNING);
+    TextureCache_SetLoader(StubLoadTexture, StubUnloadTexture);
+    if (opt.bench) {
+        const int rc = Bench_Run(opt.bench, opt.seed);
+        if (rc >= 0) return rc;
+        PrintUsage();
+        return 1;
+    }
+    b2SetAllocator(CountingB2Alloc, CountingB2Free);
+    g_jobs = Jobs_Create(opt.threads);
+    g_pathMode = opt.path;
+
+    Game game;
+    GameConfig config;
+    config.seed         = opt.seed;
+    config.levelW       = opt.width;
+    config.levelH       = opt.height;
+    config.startEnemies = opt.enemies;
+    if (opt.props >= 0) config.minProps = config.maxProps = opt.props;
+    Game_Init(&game, &config);
+
+    RestartReport restart;
+    if (opt.restartBench > 0) RestartBench(&game, opt.restartBench, &restart);
+
+    BurstReport burst;
+    if (opt.burst > 0) SpawnBurst(&game, opt.burst, &burst);
+
+    ScriptState script = { opt.seed * 2654435761u | 1u, { 0, 0 } };
+    ScriptState edits  = { opt.seed * 40503u | 1u, { 0, 0 } };   // own stream, input stays the same
+    int restarts = 0;
+    AllocReport alloc;
+    TileReport tiles;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int t = 0; t < opt.ticks; ++t) {
+        if (g_gameOver) {
+            Game_Restart(&game);
+            restarts++;
+        }
+        SimInput in = ScriptInput(&script, &game, t);
+        if (in.fire && opt.volley > 1) FireVolley(&game, &in, opt.volley);
+        if (opt.toggleTiles > 0 && t % opt.toggleTiles == opt.toggleTiles - 1) ToggleTiles(&game, &edits, &tiles);
+
+        const uint64_t before = s_heapAllocs.load(std::memory_order_relaxed) +
+                                ArenaHeapAllocs(&g_frameArena) + ArenaHeapAllocs(&g_levelArena);
+        Game_Step(&game, &in, tick);
+        const uint64_t after  = s_heapAllocs.load(std::memory_order_relaxed) +
+                                ArenaHeapAllocs(&g_frameArena) + ArenaHeapAllocs(&g_levelArena);
+
+        if (t >= opt.warmup) {
+            alloc.steadyTicks++;
+            alloc.steadyAllocs += after - before;
+            if (after != before) alloc.allocTicks++;
+        }
+    }
+    double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    if (opt.toggleTiles > 0) {
+        // Incremental chunk rebuilds must come out the same as retracing the whole grid
+        tiles.shapesEdited = Physics_StaticShapeCount();
+        Physics_UpdateTiles(game.world, &game.grid, 0, 0, game.grid.w, game.grid.h);
+        tiles.shapesRebuilt = Physics_StaticShapeCount();
+    }
+
+    PrintReport(&game, &opt, wallMs, restarts, &alloc, &burst, &restart, &tiles);
+
+    Game_Shutdown(&game);
+    Jobs_Destroy(g_jobs);
+    g_jobs = nullptr;
+
+    // Steady-state ticks must not touch the heap; a regression fails the run
+    if (alloc.steadyAllocs > 0) {
+        printf("FAILED: %llu heap allocations in Game_Step after the %d-tick warm-up\n",
+               (unsigned long long)alloc.steadyAllocs, opt.warmup);
+        return 1;
+    }
+    return 0;
+}